@@ -0,0 +1,652 @@
+#include "Benchmarks.h"
+
+import <iostream>;
+import <fstream>;
+import <sstream>;
+import <chrono>;
+import <thread>;
+import <atomic>;
+import <mutex>;
+import <cstring>;
+
+#include <Engine/Math/Matrix4.h>
+#include <Engine/Objects/Transform.h>
+#include <Engine/Objects/TransformHierarchy.h>
+#include <Engine/Assets/BinaryReader.h>
+#include <Engine/VulkanGraphics/Scene/MeshData.h>
+#include <Engine/VulkanGraphics/FileFormats/ObjParser.h>
+#include <Engine/VulkanGraphics/Scene/VertexWelder.h>
+#include <Engine/VulkanGraphics/FileFormats/NifWriter.h>
+#include <Engine/VulkanGraphics/FileFormats/NifStringTable.h>
+#include <Engine/VulkanGraphics/FileFormats/NifBlockTypes.h>
+#include <Engine/VulkanGraphics/FileFormats/FbxNodes.h>
+#include <Engine/ObjectAllocator.h>
+#include <Engine/IdentifierHeap.h>
+#include <Engine/HandleHeap.h>
+
+using namespace Engine;
+
+double Measure(const std::function<void()>& function, bool warmup)
+{
+	if (warmup)
+		function();
+
+	auto start = std::chrono::steady_clock::now();
+
+	function();
+
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+namespace
+{
+	bool ReadBenchmarkFile(const std::string& path, const char* kind, std::string& data)
+	{
+		std::ifstream file(path, std::ios::binary);
+
+		if (!file.is_open())
+		{
+			std::cout << "failed to open " << kind << " benchmark file: '" << path << "'" << std::endl;
+
+			return false;
+		}
+
+		std::stringstream contents;
+		contents << file.rdbuf();
+
+		data = contents.str();
+
+		return true;
+	}
+
+	// every thread makes a batch of items each round, frees half of it and hands the other half to its neighbour, so frees from the owning thread and from others both get exercised.
+	// check is given each item and the thread that made it right before it's freed, the number of failed checks is returned
+	template <typename Item, typename Make, typename Check, typename Free>
+	size_t RunHandoffThreads(size_t threadCount, size_t rounds, size_t batchSize, const Make& make, const Check& check, const Free& free)
+	{
+		std::vector<std::vector<Item>> handoff(threadCount);
+		std::vector<std::mutex> handoffLocks(threadCount);
+		std::vector<std::thread> threads;
+		std::atomic<size_t> failed = 0;
+
+		for (size_t i = 0; i < threadCount; ++i)
+		{
+			threads.push_back(std::thread([&, i]()
+			{
+				std::vector<Item> items;
+				std::vector<Item> received;
+				size_t neighbour = (i + 1) % threadCount;
+				size_t previous = (i + threadCount - 1) % threadCount;
+
+				items.reserve(batchSize);
+
+				for (size_t round = 0; round < rounds; ++round)
+				{
+					for (size_t j = 0; j < batchSize; ++j)
+						items.push_back(make(i));
+
+					{
+						std::lock_guard<std::mutex> lock(handoffLocks[neighbour]);
+
+						handoff[neighbour].insert(handoff[neighbour].end(), items.begin(), items.begin() + batchSize / 2);
+					}
+
+					for (size_t j = batchSize / 2; j < batchSize; ++j)
+					{
+						if (!check(items[j], i))
+							++failed;
+
+						free(items[j]);
+					}
+
+					items.clear();
+
+					{
+						std::lock_guard<std::mutex> lock(handoffLocks[i]);
+
+						received.swap(handoff[i]);
+					}
+
+					for (size_t j = 0; j < received.size(); ++j)
+					{
+						if (!check(received[j], previous))
+							++failed;
+
+						free(received[j]);
+					}
+
+					received.clear();
+				}
+			}));
+		}
+
+		for (size_t i = 0; i < threads.size(); ++i)
+			threads[i].join();
+
+		for (size_t i = 0; i < threadCount; ++i)
+		{
+			for (size_t j = 0; j < handoff[i].size(); ++j)
+			{
+				if (!check(handoff[i][j], (i + threadCount - 1) % threadCount))
+					++failed;
+
+				free(handoff[i][j]);
+			}
+		}
+
+		return failed;
+	}
+}
+
+void benchmarkMeshCopy(size_t vertexCount)
+{
+	using Graphics::VertexAttributeFormat;
+
+	std::vector<VertexAttributeFormat> sourceAttributes = {
+		VertexAttributeFormat{ Enum::AttributeDataType::Float64, 3, "position", 0 },
+		VertexAttributeFormat{ Enum::AttributeDataType::Float64, 3, "normal", 1 },
+		VertexAttributeFormat{ Enum::AttributeDataType::Float64, 2, "textureCoords", 1 },
+		VertexAttributeFormat{ Enum::AttributeDataType::Float64, 3, "binormal", 1 },
+		VertexAttributeFormat{ Enum::AttributeDataType::Float64, 3, "tangent", 1 }
+	};
+
+	std::vector<VertexAttributeFormat> destinationAttributes = sourceAttributes;
+
+	for (size_t i = 0; i < destinationAttributes.size(); ++i)
+		destinationAttributes[i].Type = Enum::AttributeDataType::Float32;
+
+	std::shared_ptr<Graphics::MeshFormat> sourceFormat = Graphics::MeshFormat::GetFormat(sourceAttributes);
+	std::shared_ptr<Graphics::MeshFormat> destinationFormat = Graphics::MeshFormat::GetFormat(destinationAttributes);
+
+	std::vector<std::vector<double>> sourceData(sourceFormat->GetBindingCount());
+	std::vector<std::vector<char>> perElementData(destinationFormat->GetBindingCount());
+	std::vector<std::vector<char>> planData(destinationFormat->GetBindingCount());
+	std::vector<const void*> sourcePointers(sourceData.size());
+	std::vector<void*> perElementPointers(perElementData.size());
+	std::vector<void*> planPointers(planData.size());
+
+	for (size_t i = 0; i < sourceData.size(); ++i)
+	{
+		sourceData[i].resize(vertexCount * sourceFormat->GetVertexSize(i) / sizeof(double));
+
+		for (size_t j = 0; j < sourceData[i].size(); ++j)
+			sourceData[i][j] = 0.001 * (double)j - 500;
+
+		sourcePointers[i] = sourceData[i].data();
+	}
+
+	for (size_t i = 0; i < planData.size(); ++i)
+	{
+		perElementData[i].resize(vertexCount * destinationFormat->GetVertexSize(i));
+		planData[i].resize(vertexCount * destinationFormat->GetVertexSize(i));
+
+		perElementPointers[i] = perElementData[i].data();
+		planPointers[i] = planData[i].data();
+	}
+
+	double perElementTime = Measure([&]() { sourceFormat->CopyPerElement(sourcePointers.data(), perElementPointers.data(), destinationFormat, vertexCount); });
+	double planTime = Measure([&]() { sourceFormat->Copy(sourcePointers.data(), planPointers.data(), destinationFormat, vertexCount); });
+
+	bool matches = perElementData == planData;
+
+	std::cout << "mesh copy benchmark; " << vertexCount << " vertices, float64 -> float32" << std::endl;
+	std::cout << "\tper element: " << perElementTime << "ms" << std::endl;
+	std::cout << "\tconversion plan: " << planTime << "ms (" << sourceFormat->GetConversionPlan(destinationFormat)->GetSpans().size() << " spans)" << std::endl;
+	std::cout << "\tspeedup: " << (perElementTime / planTime) << "x, output " << (matches ? "matches" : "DIFFERS") << std::endl;
+}
+
+void benchmarkBinaryReader(size_t count)
+{
+	std::vector<float> values(count);
+
+	for (size_t i = 0; i < count; ++i)
+		values[i] = 0.001f * (float)i - 500;
+
+	std::string bytes(reinterpret_cast<const char*>(values.data()), count * sizeof(float));
+
+	std::cout << "binary reader benchmark; " << count << " floats" << std::endl;
+
+	for (std::endian order : { std::endian::native, std::endian::native == std::endian::little ? std::endian::big : std::endian::little })
+	{
+		Endian endian(order);
+
+		std::vector<float> perScalar(count);
+		std::vector<float> bulk(count);
+
+		double perScalarTime = Measure([&]()
+		{
+			std::istringstream stream(bytes);
+
+			for (size_t i = 0; i < count; ++i)
+				perScalar[i] = endian.read<float>(stream);
+		});
+
+		double bulkTime = Measure([&]()
+		{
+			BinaryReader reader(bytes.data(), bytes.size(), endian);
+
+			reader.readArray(bulk.data(), count);
+		});
+
+		bool matches = std::memcmp(perScalar.data(), bulk.data(), count * sizeof(float)) == 0;
+
+		std::cout << "\t" << (endian.ShouldSwap ? "swapped" : "native") << " order" << std::endl;
+		std::cout << "\t\tper scalar istream: " << perScalarTime << "ms" << std::endl;
+		std::cout << "\t\tbinary reader: " << bulkTime << "ms" << std::endl;
+		std::cout << "\t\tspeedup: " << (perScalarTime / bulkTime) << "x, output " << (matches ? "matches" : "DIFFERS") << std::endl;
+	}
+}
+
+void benchmarkObjParser(const std::string& path)
+{
+	std::string data;
+
+	if (!ReadBenchmarkFile(path, "obj", data))
+		return;
+
+	double megabytes = (double)data.size() / (1024 * 1024);
+
+	Graphics::ObjParser characterParser;
+	Graphics::ObjParser chunkedParser;
+
+	double characterTime = Measure([&]()
+	{
+		std::istringstream stream(data);
+
+		characterParser.ParseCharacters(stream, path);
+	}, false);
+
+	double chunkedTime = Measure([&]() { chunkedParser.Parse(data.data(), data.size(), path); }, false);
+
+	bool matches = characterParser.Faces.size() == chunkedParser.Faces.size() && characterParser.Vertices.size() == chunkedParser.Vertices.size();
+
+	std::cout << "obj parser benchmark; '" << path << "', " << megabytes << " MB" << std::endl;
+	std::cout << "\tcharacter at a time: " << characterTime << "ms (" << (megabytes * 1000 / characterTime) << " MB/s)" << std::endl;
+	std::cout << "\tchunked: " << chunkedTime << "ms (" << (megabytes * 1000 / chunkedTime) << " MB/s)" << std::endl;
+	std::cout << "\tspeedup: " << (characterTime / chunkedTime) << "x, " << chunkedParser.Faces.size() << " faces, output " << (matches ? "matches" : "DIFFERS") << std::endl;
+
+	std::vector<Graphics::ObjVertex> expanded;
+
+	Graphics::ExpandObjFaces(chunkedParser, expanded);
+
+	Graphics::VertexWelder welder;
+
+	double weldTime = Measure([&]() { welder.Weld(expanded.data(), sizeof(Graphics::ObjVertex), expanded.size()); });
+
+	std::cout << "\twelding: " << weldTime << "ms, " << welder.GetInputCount() << " -> " << welder.GetUniqueCount() << " vertices (" << welder.GetReductionRatio() << "x)" << std::endl;
+}
+
+void benchmarkNifStrings(size_t nodeCount)
+{
+	// roughly the string traffic a mesh node generates on export: its own name plus the shared semantic, extra data and morph names
+	std::vector<std::string> sharedNames = { "", "FresnelBoost", "FresnelExponent", "OverrideColor0", "OverrideColor1", "OverrideColor2", "HairTangentMapIndex", "ColorOverrideMapIndex", "ColorBoost", "INDEX", "POSITION", "NORMAL", "TEXCOORD", "BINORMAL", "TANGENT", "MORPH_POSITION", "MORPH_WEIGHTS", "Base" };
+	std::vector<std::string> writes;
+
+	writes.reserve(nodeCount * (sharedNames.size() + 2));
+
+	for (size_t i = 0; i < nodeCount; ++i)
+	{
+		std::string name = "node_" + std::to_string(i);
+
+		writes.push_back(name);
+		writes.insert(writes.end(), sharedNames.begin(), sharedNames.end());
+		writes.push_back(name);
+	}
+
+	std::vector<std::string> linearStrings;
+	std::vector<unsigned int> linearRefs(writes.size());
+	std::vector<unsigned int> internedRefs(writes.size());
+	NifStringTable table;
+
+	// both tables fill up as they go, so a warmup run would leave nothing but hits to time
+	double linearTime = Measure([&]()
+	{
+		for (size_t i = 0; i < writes.size(); ++i)
+		{
+			unsigned int index = 0;
+
+			for (; index < linearStrings.size() && linearStrings[index] != writes[i]; ++index);
+
+			if (index == linearStrings.size())
+				linearStrings.push_back(writes[i]);
+
+			linearRefs[i] = index;
+		}
+	}, false);
+
+	double internedTime = Measure([&]()
+	{
+		for (size_t i = 0; i < writes.size(); ++i)
+			internedRefs[i] = table.Intern(writes[i]);
+	}, false);
+
+	bool matches = linearRefs == internedRefs && linearStrings.size() == table.GetCount();
+
+	Graphics::ModelPackage package;
+
+	package.Nodes.resize(nodeCount);
+
+	for (size_t i = 0; i < nodeCount; ++i)
+	{
+		package.Nodes[i].Name = "node_" + std::to_string(i);
+		package.Nodes[i].AttachedTo = i == 0 ? (size_t)-1 : (i - 1) / 8;
+		package.Nodes[i].Transform = Engine::Create<Transform>();
+	}
+
+	size_t exportSize = 0;
+
+	double exportTime = Measure([&]()
+	{
+		NifWriter writer;
+		std::stringstream stream;
+
+		writer.Package = &package;
+		writer.Write(stream);
+
+		exportSize = stream.str().size();
+	});
+
+	std::cout << "nif string table benchmark; " << writes.size() << " string writes, " << table.GetCount() << " unique" << std::endl;
+	std::cout << "\tlinear scan: " << linearTime << "ms" << std::endl;
+	std::cout << "\tinterned: " << internedTime << "ms" << std::endl;
+	std::cout << "\tspeedup: " << (linearTime / internedTime) << "x, refs " << (matches ? "match" : "DIFFER") << std::endl;
+	std::cout << "\t" << nodeCount << " node nif export: " << exportTime << "ms, " << exportSize << " bytes" << std::endl;
+}
+
+void benchmarkFbxNodes(const std::string& path)
+{
+	std::string data;
+
+	if (!ReadBenchmarkFile(path, "fbx", data))
+		return;
+
+	double megabytes = (double)data.size() / (1024 * 1024);
+
+	std::cout << "fbx node tree benchmark; '" << path << "', " << megabytes << " MB" << std::endl;
+
+	double heapReadTime = 0;
+
+	// a block size of 0 sends every node list and name to the heap, the same requests the tree made before it had an arena
+	for (size_t blockSize : { (size_t)0, Engine::MemoryArena::DefaultBlockSize })
+	{
+		std::unique_ptr<FbxFileStructure> fbxFile = std::make_unique<FbxFileStructure>(blockSize);
+
+		double readTime = Measure([&]() { fbxFile->ReadNodes(data.data(), data.size()); }, false);
+
+		size_t nodeCount = fbxFile->Nodes.size();
+		size_t allocations = fbxFile->Arena.GetAllocationCount();
+		size_t blocks = fbxFile->Arena.GetBlockCount();
+		size_t bytes = fbxFile->Arena.GetBytesReserved();
+
+		double freeTime = Measure([&]() { fbxFile.reset(); }, false);
+
+		std::cout << "\t" << (blockSize == 0 ? "heap" : "arena") << ": " << nodeCount << " nodes, " << allocations << " allocations, " << blocks << " heap blocks, " << bytes << " bytes" << std::endl;
+		std::cout << "\t\tread: " << readTime << "ms, free: " << freeTime << "ms" << std::endl;
+
+		if (blockSize == 0)
+			heapReadTime = readTime;
+		else
+			std::cout << "\tread speedup: " << (heapReadTime / readTime) << "x" << std::endl;
+	}
+}
+
+void benchmarkNifDocument(const std::string& path)
+{
+	std::string data;
+
+	if (!ReadBenchmarkFile(path, "nif", data))
+		return;
+
+	double megabytes = (double)data.size() / (1024 * 1024);
+
+	std::cout << "nif document benchmark; '" << path << "', " << megabytes << " MB" << std::endl;
+
+	double heapTime = 0;
+
+	for (size_t blockSize : { (size_t)0, Engine::MemoryArena::DefaultBlockSize })
+	{
+		std::unique_ptr<NifDocument> document = std::make_unique<NifDocument>(blockSize);
+
+		double parseTime = Measure([&]() { document->Read(data.data(), data.size()); }, false);
+
+		size_t blockCount = document->Blocks.size();
+		size_t allocations = document->GetArenaAllocationCount();
+		size_t heapBlocks = document->GetArenaBlockCount();
+
+		double teardownTime = Measure([&]() { document.reset(); }, false);
+
+		std::cout << "\t" << (blockSize == 0 ? "heap" : "arena") << ": " << blockCount << " blocks, " << allocations << " allocations, " << heapBlocks << " heap blocks" << std::endl;
+		std::cout << "\t\tparse: " << parseTime << "ms, teardown: " << teardownTime << "ms" << std::endl;
+
+		if (blockSize == 0)
+			heapTime = parseTime + teardownTime;
+		else
+			std::cout << "\tparse + teardown speedup: " << (heapTime / (parseTime + teardownTime)) << "x" << std::endl;
+	}
+}
+
+void benchmarkPageAllocator(size_t rounds, size_t batchSize)
+{
+	struct Payload
+	{
+		size_t Values[6] = {};
+	};
+
+	static PageAllocator<sizeof(Payload), Engine_PoolPageSize> allocator;
+
+	size_t threadCount = std::max<size_t>(2, std::thread::hardware_concurrency());
+
+	std::cout << "page allocator benchmark; " << threadCount << " threads, " << rounds << " rounds of " << batchSize << " objects each" << std::endl;
+
+	double lockedRate = 0;
+
+	for (bool caching : { false, true })
+	{
+		allocator.ThreadCaching = caching;
+
+		size_t corrupted = 0;
+
+		double time = Measure([&]()
+		{
+			corrupted = RunHandoffThreads<Payload*>(threadCount, rounds, batchSize,
+				[](size_t thread) { Payload* payload = allocator.Create<Payload>(); payload->Values[0] = thread; return payload; },
+				[](Payload* payload, size_t thread) { return payload->Values[0] == thread; },
+				[](Payload* payload) { allocator.Destroy(payload); }
+			);
+		});
+
+		double rate = (double)(2 * threadCount * rounds * batchSize) / (time * 1000);
+
+		std::cout << "\t" << (caching ? "thread caches" : "shared lock") << ": " << time << "ms, " << rate << " million allocations + frees/s" << (corrupted > 0 ? ", CORRUPTED" : "") << std::endl;
+
+		if (!caching)
+			lockedRate = rate;
+		else
+			std::cout << "\tspeedup: " << (rate / lockedRate) << "x" << std::endl;
+	}
+}
+
+void benchmarkObjectIDs(size_t rounds, size_t batchSize)
+{
+	struct Payload
+	{
+		void* Data = nullptr;
+		size_t Owner = 0;
+	};
+
+	std::cout << "object id benchmark; " << rounds << " rounds of " << batchSize << " ids per thread" << std::endl;
+
+	// every id gets looked up once before it's released
+	auto run = [&](size_t threadCount, auto acquire, auto isValid, auto release)
+	{
+		size_t invalid = 0;
+
+		double time = Measure([&]()
+		{
+			invalid = RunHandoffThreads<unsigned long long>(threadCount, rounds, batchSize,
+				[&](size_t thread) { return acquire(Payload{ nullptr, thread }); },
+				[&](unsigned long long id, size_t) { return isValid(id); },
+				release
+			);
+		});
+
+		if (invalid > 0)
+			std::cout << "\t\tINVALID IDS: " << invalid << std::endl;
+
+		return (double)(threadCount * rounds * batchSize) / (time * 1000);
+	};
+
+	for (size_t threadCount : { 1, 2, 4, 8, 16, 32 })
+	{
+		IDHeap<Payload> lockedHeap;
+		std::mutex lockedHeapMutex;
+
+		double lockedRate = run(threadCount,
+			[&](const Payload& payload) { std::lock_guard<std::mutex> lock(lockedHeapMutex); return (unsigned long long)lockedHeap.RequestID(payload); },
+			[&](unsigned long long id) { std::lock_guard<std::mutex> lock(lockedHeapMutex); return lockedHeap.NodeAllocated((int)id); },
+			[&](unsigned long long id) { std::lock_guard<std::mutex> lock(lockedHeapMutex); lockedHeap.Release((int)id); }
+		);
+
+		std::unique_ptr<Engine::HandleHeap<Payload>> handleHeap = std::make_unique<Engine::HandleHeap<Payload>>();
+
+		double shardedRate = run(threadCount,
+			[&](const Payload& payload) { return handleHeap->Acquire(payload); },
+			[&](unsigned long long id) { return handleHeap->IsValid(id); },
+			[&](unsigned long long id) { handleHeap->Release(id); }
+		);
+
+		std::cout << "\t" << threadCount << " threads: locked IDHeap " << lockedRate << ", sharded HandleHeap " << shardedRate << " million acquire + release/s, speedup: " << (shardedRate / lockedRate) << "x" << std::endl;
+	}
+}
+
+void benchmarkTransformHierarchy(size_t nodeCount, size_t frames)
+{
+	// skeleton shaped: a spine with short limb chains branching off of it
+	std::vector<size_t> parents(nodeCount);
+	std::vector<Matrix4> transformations(nodeCount);
+
+	for (size_t i = 0; i < nodeCount; ++i)
+	{
+		parents[i] = i == 0 ? TransformHierarchy::NoParent : (i % 4 == 1 ? (i - 1) / 2 : i - 1);
+		transformations[i] = Matrix4(0, 0.1f, 0) * Matrix4::YawRotation(0.01f * (float)(i % 7));
+	}
+
+	std::cout << "transform hierarchy benchmark; " << nodeCount << " nodes, " << frames << " frames" << std::endl;
+
+	std::vector<std::shared_ptr<Transform>> objects(nodeCount);
+
+	double objectCreateTime = Measure([&]()
+	{
+		for (size_t i = 0; i < nodeCount; ++i)
+		{
+			objects[i] = Engine::Create<Transform>();
+			objects[i]->SetTransformation(transformations[i]);
+
+			if (parents[i] != TransformHierarchy::NoParent)
+				objects[i]->SetParent(objects[parents[i]]);
+		}
+	}, false);
+
+	double objectUpdateTime = Measure([&]()
+	{
+		for (size_t frame = 0; frame < frames; ++frame)
+		{
+			objects[0]->SetTransformation(Matrix4::YawRotation(0.01f * (float)frame));
+			objects[0]->Update(0);
+		}
+	});
+
+	TransformHierarchy hierarchy;
+
+	double hierarchyCreateTime = Measure([&]()
+	{
+		hierarchy.Reserve(nodeCount);
+
+		for (size_t i = 0; i < nodeCount; ++i)
+			hierarchy.Add(parents[i], transformations[i]);
+	}, false);
+
+	double hierarchyUpdateTime = Measure([&]()
+	{
+		for (size_t frame = 0; frame < frames; ++frame)
+		{
+			hierarchy.Transformations[0] = Matrix4::YawRotation(0.01f * (float)frame);
+			hierarchy.Update();
+		}
+	});
+
+	size_t objectBytes = nodeCount * sizeof(Transform);
+
+	std::cout << "\ttransform objects: create " << objectCreateTime << "ms, " << (objectUpdateTime / frames) << "ms per frame, at least " << objectBytes << " bytes" << std::endl;
+	std::cout << "\tflat hierarchy: create " << hierarchyCreateTime << "ms, " << (hierarchyUpdateTime / frames) << "ms per frame, " << hierarchy.GetMemoryUsage() << " bytes" << std::endl;
+	std::cout << "\tupdate speedup: " << (objectUpdateTime / hierarchyUpdateTime) << "x" << std::endl;
+}
+
+void benchmarkTransformChain(size_t boneCount, size_t frames)
+{
+	std::vector<std::shared_ptr<Transform>> bones(boneCount);
+
+	for (size_t i = 0; i < boneCount; ++i)
+	{
+		bones[i] = Engine::Create<Transform>();
+
+		if (i > 0)
+			bones[i]->SetParent(bones[i - 1]);
+	}
+
+	std::cout << "transform chain benchmark; " << boneCount << " bones, " << frames << " frames" << std::endl;
+
+	// every bone gets its rotation, position and scale set each frame like an animation would, then the whole chain is read like a draw would
+	auto animate = [&](const std::function<void(size_t)>& edited)
+	{
+		for (size_t frame = 0; frame < frames; ++frame)
+		{
+			for (size_t i = 0; i < boneCount; ++i)
+			{
+				bones[i]->SetEulerAngles(0, 0.01f * (float)((frame + i) % 13), 0);
+				edited(i);
+				bones[i]->SetPosition(Vector3(0, 0.1f, 0));
+				edited(i);
+				bones[i]->SetScale(Vector3(1, 1, 1));
+				edited(i);
+			}
+
+			bones[0]->GetWorldTransformationInverse();
+
+			for (size_t i = 0; i < boneCount; ++i)
+				bones[i]->GetWorldTransformation();
+		}
+	};
+
+	// what recomputing on every edit used to cost: the edited bone and everything under it rebuilt all of their world matrices straight away
+	double eagerTime = Measure([&]()
+	{
+		animate([&](size_t edited)
+		{
+			for (size_t i = edited; i < boneCount; ++i)
+			{
+				bones[i]->GetWorldTransformationInverse();
+				bones[i]->GetWorldNormalTransformation();
+				bones[i]->GetWorldRotation();
+			}
+		});
+	});
+
+	double lazyTime = Measure([&]()
+	{
+		animate([](size_t) {});
+	});
+
+	Matrix4 expected = bones[0]->GetTransformation();
+	bool matches = expected == bones[0]->GetWorldTransformation();
+
+	for (size_t i = 1; i < boneCount; ++i)
+	{
+		expected = expected * bones[i]->GetTransformation();
+		matches &= expected == bones[i]->GetWorldTransformation();
+	}
+
+	std::cout << "\teager: " << (eagerTime / frames) << "ms per frame" << std::endl;
+	std::cout << "\tlazy: " << (lazyTime / frames) << "ms per frame" << std::endl;
+	std::cout << "\tspeedup: " << (eagerTime / lazyTime) << "x, world transforms " << (matches ? "match" : "DIFFER") << std::endl;
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+import <string>;
+import <functional>;
+
+// times one run of function in milliseconds. by default it runs once untimed first, so page faults and lazily built caches don't all land on whichever variant goes first.
+// runs that use up their own state, like parsing into a fresh structure or tearing one down, have to skip the warmup
+double Measure(const std::function<void()>& function, bool warmup = true);
+
+void benchmarkMeshCopy(size_t vertexCount = 1000000);
+void benchmarkBinaryReader(size_t count = 4000000);
+void benchmarkObjParser(const std::string& path);
+void benchmarkNifStrings(size_t nodeCount = 10000);
+void benchmarkFbxNodes(const std::string& path);
+void benchmarkNifDocument(const std::string& path);
+void benchmarkPageAllocator(size_t rounds = 2000, size_t batchSize = 256);
+void benchmarkObjectIDs(size_t rounds = 500, size_t batchSize = 256);
+void benchmarkTransformHierarchy(size_t nodeCount = 5000, size_t frames = 100);
+void benchmarkTransformChain(size_t boneCount = 1000, size_t frames = 10);
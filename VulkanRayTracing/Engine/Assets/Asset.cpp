@@ -102,12 +102,31 @@ namespace Engine
 
 		outPath.replace_extension(outExtension);
 
-		std::ofstream file(outPath, std::ios::out | Mode);
+		// written off to the side and renamed over the old output, so an output that's hard linked to a cache entry gets replaced instead of written through
+		FilePath temporary = outPath;
+		temporary += ".tmp";
 
-		if (!file.is_open())
-			return false;
+		{
+			std::ofstream file(temporary, std::ios::out | Mode);
+
+			if (!file.is_open())
+				return false;
+
+			Saving(file, outExtension);
+		}
 
-		Saving(file, outExtension);
+		std::error_code error;
+
+		std::filesystem::rename(temporary, outPath, error);
+
+		if (error)
+		{
+			std::error_code ignored;
+
+			std::filesystem::remove(temporary, ignored);
+
+			return false;
+		}
 
 		return true;
 	}
@@ -0,0 +1,107 @@
+#include "AssetCache.h"
+
+import <string>;
+import <sstream>;
+import <iomanip>;
+import <thread>;
+import <functional>;
+
+#include "ContentHash.h"
+#include "MappedFile.h"
+
+namespace Engine
+{
+	AssetCache::AssetCache(const FilePath& directory) : Directory(directory)
+	{
+		std::error_code error;
+
+		std::filesystem::create_directories(Directory, error);
+	}
+
+	bool AssetCache::HashInput(const FilePath& input, ContentHash& hash) const
+	{
+		MappedFile file;
+
+		hash.Push(ConverterVersion);
+
+		if (file.Open(input))
+		{
+			hash.Push(file.GetSize());
+			hash.Push(file.GetData(), file.GetSize());
+
+			return true;
+		}
+
+		// empty files can't be mapped, but they still have a perfectly good hash
+		std::error_code error;
+		std::uintmax_t size = std::filesystem::file_size(input, error);
+
+		if (error || size != 0)
+			return false;
+
+		hash.Push((size_t)0);
+
+		return true;
+	}
+
+	bool AssetCache::Fetch(unsigned long long key, const FilePath& output) const
+	{
+		FilePath entry = GetEntryPath(key, output.extension());
+
+		std::error_code error;
+
+		if (!std::filesystem::is_regular_file(entry, error))
+			return false;
+
+		std::filesystem::remove(output, error);
+
+		// linking is free and safe since exports rename a new file over the output rather than writing through it, copying is only for when the cache sits on another volume
+		std::filesystem::create_hard_link(entry, output, error);
+
+		if (error)
+			std::filesystem::copy_file(entry, output, std::filesystem::copy_options::overwrite_existing, error);
+
+		return !error;
+	}
+
+	bool AssetCache::Store(unsigned long long key, const FilePath& output) const
+	{
+		FilePath entry = GetEntryPath(key, output.extension());
+
+		std::stringstream suffix;
+		suffix << "." << std::hash<std::thread::id>()(std::this_thread::get_id()) << ".tmp";
+
+		FilePath temporary = entry;
+		temporary += suffix.str();
+
+		// entries are written off to the side and renamed in, so a job reading the same key never sees half of a file
+		std::error_code error;
+
+		std::filesystem::copy_file(output, temporary, std::filesystem::copy_options::overwrite_existing, error);
+
+		if (!error)
+			std::filesystem::rename(temporary, entry, error);
+
+		if (error)
+		{
+			std::error_code ignored;
+
+			std::filesystem::remove(temporary, ignored);
+
+			return false;
+		}
+
+		return true;
+	}
+
+	AssetCache::FilePath AssetCache::GetEntryPath(unsigned long long key, const FilePath& extension) const
+	{
+		std::stringstream name;
+		name << std::hex << std::setw(16) << std::setfill('0') << key;
+
+		FilePath entry = Directory / name.str();
+		entry += extension;
+
+		return entry;
+	}
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+import <filesystem>;
+
+namespace Engine
+{
+	class ContentHash;
+
+	// converted outputs stored by a hash of their input, converter version and export settings
+	class AssetCache
+	{
+	public:
+		typedef std::filesystem::path FilePath;
+
+		// bump whenever a change to the parsers or writers changes what gets exported, or stale outputs will be served
+		static const unsigned int ConverterVersion = 6;
+
+		AssetCache(const FilePath& directory);
+
+		bool HashInput(const FilePath& input, ContentHash& hash) const;
+		bool Fetch(unsigned long long key, const FilePath& output) const;
+		bool Store(unsigned long long key, const FilePath& output) const;
+		FilePath GetEntryPath(unsigned long long key, const FilePath& extension) const;
+		const FilePath& GetDirectory() const { return Directory; }
+
+	private:
+		FilePath Directory;
+	};
+}
@@ -0,0 +1,76 @@
+#include "BinaryReader.h"
+
+import <utility>;
+
+#if defined(_M_X64) || defined(__x86_64__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define BINARY_READER_SSE2
+
+#include <emmintrin.h>
+#endif
+
+void BinaryReader::seek(size_t position)
+{
+	if (position > Size)
+		throw "seek past the end of the buffer";
+
+	Position = position;
+}
+
+#ifdef BINARY_READER_SSE2
+__m128i SwapBytes16(__m128i value)
+{
+	return _mm_or_si128(_mm_slli_epi16(value, 8), _mm_srli_epi16(value, 8));
+}
+
+__m128i SwapBytes32(__m128i value)
+{
+	value = _mm_shufflehi_epi16(_mm_shufflelo_epi16(value, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+
+	return SwapBytes16(value);
+}
+
+__m128i SwapBytes64(__m128i value)
+{
+	value = _mm_shufflehi_epi16(_mm_shufflelo_epi16(value, _MM_SHUFFLE(0, 1, 2, 3)), _MM_SHUFFLE(0, 1, 2, 3));
+
+	return SwapBytes16(value);
+}
+#endif
+
+void ByteSwap(void* data, size_t count, size_t elementSize)
+{
+	char* bytes = reinterpret_cast<char*>(data);
+	size_t i = 0;
+
+#ifdef BINARY_READER_SSE2
+	// sse2 only has 16 bit shifts and word shuffles, so wider elements get their words reversed first and then the bytes in each word
+	__m128i(*swap)(__m128i) = nullptr;
+
+	if (elementSize == 2)
+		swap = &SwapBytes16;
+	else if (elementSize == 4)
+		swap = &SwapBytes32;
+	else if (elementSize == 8)
+		swap = &SwapBytes64;
+
+	if (swap != nullptr)
+	{
+		size_t perVector = 16 / elementSize;
+
+		for (; i + perVector <= count; i += perVector)
+		{
+			__m128i* vector = reinterpret_cast<__m128i*>(bytes + i * elementSize);
+
+			_mm_storeu_si128(vector, swap(_mm_loadu_si128(vector)));
+		}
+	}
+#endif
+
+	for (; i < count; ++i)
+	{
+		char* element = bytes + i * elementSize;
+
+		for (size_t j = 0; j < elementSize / 2; ++j)
+			std::swap(element[j], element[elementSize - j - 1]);
+	}
+}
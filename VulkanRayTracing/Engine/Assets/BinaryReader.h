@@ -0,0 +1,93 @@
+#pragma once
+
+import <vector>;
+import <cstring>;
+import <type_traits>;
+
+#include "ParserUtils.h"
+
+void ByteSwap(void* data, size_t count, size_t elementSize);
+
+// reads out of a contiguous buffer. arrays come out with one copy and get their byte order fixed in bulk instead of a scalar at a time
+class BinaryReader
+{
+public:
+	::Endian Endian;
+
+	BinaryReader() {}
+	BinaryReader(const char* data, size_t size, const ::Endian& endian = ::Endian()) : Endian(endian), Data(data), Size(size) {}
+
+	template <typename T>
+	T read()
+	{
+		static_assert(std::is_arithmetic_v<T> || std::is_enum_v<T>, "only scalars have a byte order to fix");
+
+		T value;
+
+		std::memcpy(&value, take(sizeof(T)), sizeof(T));
+
+		if (sizeof(T) > 1 && Endian.ShouldSwap)
+			ByteSwap(&value, 1, sizeof(T));
+
+		return value;
+	}
+
+	template <typename T>
+	void readArray(T* output, size_t count)
+	{
+		static_assert(std::is_arithmetic_v<T> || std::is_enum_v<T>, "only scalars have a byte order to fix");
+
+		if (count > remaining() / sizeof(T))
+			throw "read past the end of the buffer";
+
+		if (count == 0)
+			return;
+
+		std::memcpy(output, take(count * sizeof(T)), count * sizeof(T));
+
+		if (sizeof(T) > 1 && Endian.ShouldSwap)
+			ByteSwap(output, count, sizeof(T));
+	}
+
+	template <typename T>
+	std::vector<T> readArray(size_t count)
+	{
+		std::vector<T> values(count);
+
+		readArray(values.data(), count);
+
+		return values;
+	}
+
+	void read(char* output, size_t length)
+	{
+		if (length > 0)
+			std::memcpy(output, take(length), length);
+	}
+
+	const char* readSpan(size_t length) { return take(length); }
+	void skip(size_t length) { take(length); }
+	void seek(size_t position);
+
+	const char* data() const { return Data; }
+	size_t size() const { return Size; }
+	size_t tell() const { return Position; }
+	size_t remaining() const { return Size - Position; }
+
+private:
+	const char* Data = nullptr;
+	size_t Size = 0;
+	size_t Position = 0;
+
+	const char* take(size_t length)
+	{
+		if (length > Size - Position)
+			throw "read past the end of the buffer";
+
+		const char* bytes = Data + Position;
+
+		Position += length;
+
+		return bytes;
+	}
+};
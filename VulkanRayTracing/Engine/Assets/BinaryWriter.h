@@ -0,0 +1,35 @@
+#pragma once
+
+import <cstring>;
+
+// writes into a fixed span of a preallocated buffer. constructed without one it only counts bytes, so the same serialization code can size its output before anything is allocated
+class BinaryWriter
+{
+public:
+	BinaryWriter() {}
+	BinaryWriter(char* data, size_t size) : Data(data), Size(size) {}
+
+	void write(const char* data, size_t length)
+	{
+		if (Data != nullptr)
+		{
+			if (length > Size - Position)
+				throw "write past the end of the buffer";
+
+			if (length > 0)
+				std::memcpy(Data + Position, data, length);
+		}
+
+		Position += length;
+	}
+
+	bool isMeasuring() const { return Data == nullptr; }
+	char* data() const { return Data; }
+	size_t size() const { return Size; }
+	size_t tell() const { return Position; }
+
+private:
+	char* Data = nullptr;
+	size_t Size = 0;
+	size_t Position = 0;
+};
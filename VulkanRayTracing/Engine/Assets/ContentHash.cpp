@@ -0,0 +1,152 @@
+#include "ContentHash.h"
+
+import <cstring>;
+import <bit>;
+
+namespace Engine
+{
+	const unsigned long long Prime1 = 11400714785074694791ull;
+	const unsigned long long Prime2 = 14029467366897019727ull;
+	const unsigned long long Prime3 = 1609587929392839161ull;
+	const unsigned long long Prime4 = 9650029242287828579ull;
+	const unsigned long long Prime5 = 2870177450012600261ull;
+
+	unsigned long long ReadLane64(const unsigned char* data)
+	{
+		// assembled a byte at a time so the hash doesn't depend on the host byte order; this still compiles down to one load
+		unsigned long long value = 0;
+
+		for (size_t i = 0; i < 8; ++i)
+			value |= (unsigned long long)data[i] << (8 * i);
+
+		return value;
+	}
+
+	unsigned long long ReadLane32(const unsigned char* data)
+	{
+		return (unsigned long long)data[0] | ((unsigned long long)data[1] << 8) | ((unsigned long long)data[2] << 16) | ((unsigned long long)data[3] << 24);
+	}
+
+	unsigned long long MixLane(unsigned long long lane, unsigned long long input)
+	{
+		lane += input * Prime2;
+
+		return std::rotl(lane, 31) * Prime1;
+	}
+
+	unsigned long long MergeLane(unsigned long long hash, unsigned long long lane)
+	{
+		hash ^= MixLane(0, lane);
+
+		return hash * Prime1 + Prime4;
+	}
+
+	ContentHash::ContentHash(unsigned long long seed) : Seed(seed)
+	{
+		Lanes[0] = seed + Prime1 + Prime2;
+		Lanes[1] = seed + Prime2;
+		Lanes[2] = seed;
+		Lanes[3] = seed - Prime1;
+	}
+
+	void ContentHash::Push(const void* data, size_t size)
+	{
+		const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+
+		TotalSize += size;
+
+		if (PendingSize + size < 32)
+		{
+			std::memcpy(Pending + PendingSize, bytes, size);
+			PendingSize += size;
+
+			return;
+		}
+
+		if (PendingSize > 0)
+		{
+			size_t fill = 32 - PendingSize;
+
+			std::memcpy(Pending + PendingSize, bytes, fill);
+
+			for (size_t i = 0; i < 4; ++i)
+				Lanes[i] = MixLane(Lanes[i], ReadLane64(Pending + i * 8));
+
+			bytes += fill;
+			size -= fill;
+			PendingSize = 0;
+		}
+
+		// whole 32 byte stripes go straight through without being staged
+		for (; size >= 32; bytes += 32, size -= 32)
+			for (size_t i = 0; i < 4; ++i)
+				Lanes[i] = MixLane(Lanes[i], ReadLane64(bytes + i * 8));
+
+		std::memcpy(Pending, bytes, size);
+		PendingSize = size;
+	}
+
+	void ContentHash::Push(const std::string& text)
+	{
+		Push<unsigned long long>(text.size());
+		Push(text.data(), text.size());
+	}
+
+	unsigned long long ContentHash::Finish() const
+	{
+		unsigned long long hash = 0;
+
+		if (TotalSize >= 32)
+		{
+			hash = std::rotl(Lanes[0], 1) + std::rotl(Lanes[1], 7) + std::rotl(Lanes[2], 12) + std::rotl(Lanes[3], 18);
+
+			for (size_t i = 0; i < 4; ++i)
+				hash = MergeLane(hash, Lanes[i]);
+		}
+		else
+			hash = Seed + Prime5;
+
+		hash += TotalSize;
+
+		const unsigned char* bytes = Pending;
+		size_t size = PendingSize;
+
+		for (; size >= 8; bytes += 8, size -= 8)
+		{
+			hash ^= MixLane(0, ReadLane64(bytes));
+			hash = std::rotl(hash, 27) * Prime1 + Prime4;
+		}
+
+		if (size >= 4)
+		{
+			hash ^= ReadLane32(bytes) * Prime1;
+			hash = std::rotl(hash, 23) * Prime2 + Prime3;
+
+			bytes += 4;
+			size -= 4;
+		}
+
+		for (; size > 0; ++bytes, --size)
+		{
+			hash ^= (unsigned long long)*bytes * Prime5;
+			hash = std::rotl(hash, 11) * Prime1;
+		}
+
+		hash ^= hash >> 33;
+		hash *= Prime2;
+		hash ^= hash >> 29;
+		hash *= Prime3;
+		hash ^= hash >> 32;
+
+		return hash;
+	}
+
+	unsigned long long ContentHash::Hash(const void* data, size_t size, unsigned long long seed)
+	{
+		ContentHash hash(seed);
+
+		hash.Push(data, size);
+
+		return hash.Finish();
+	}
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+import <string>;
+
+namespace Engine
+{
+	// xxhash64, so identical inputs hash identically no matter which machine converted them
+	class ContentHash
+	{
+	public:
+		ContentHash(unsigned long long seed = 0);
+
+		void Push(const void* data, size_t size);
+		void Push(const std::string& text);
+
+		template <typename T>
+		void Push(const T& value)
+		{
+			Push(&value, sizeof(T));
+		}
+
+		unsigned long long Finish() const;
+
+		static unsigned long long Hash(const void* data, size_t size, unsigned long long seed = 0);
+
+	private:
+		unsigned long long Lanes[4] = {};
+		unsigned long long Seed = 0;
+		unsigned long long TotalSize = 0;
+		unsigned char Pending[32] = {};
+		size_t PendingSize = 0;
+	};
+}
@@ -0,0 +1,116 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace Engine
+{
+	MappedFile::MappedFile(const std::filesystem::path& path)
+	{
+		Open(path);
+	}
+
+	MappedFile::~MappedFile()
+	{
+		Close();
+	}
+
+	// pages are mapped copy on write so callers that poke at parsed data in place never touch the file
+	bool MappedFile::Open(const std::filesystem::path& path)
+	{
+		Close();
+
+#ifdef _WIN32
+		HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+		if (file == INVALID_HANDLE_VALUE)
+			return false;
+
+		LARGE_INTEGER size = {};
+
+		if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+		{
+			CloseHandle(file);
+
+			return false;
+		}
+
+		HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+
+		if (mapping == nullptr)
+		{
+			CloseHandle(file);
+
+			return false;
+		}
+
+		void* view = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+
+		if (view == nullptr)
+		{
+			CloseHandle(mapping);
+			CloseHandle(file);
+
+			return false;
+		}
+
+		FileHandle = file;
+		MappingHandle = mapping;
+		Data = reinterpret_cast<const char*>(view);
+		Size = (size_t)size.QuadPart;
+#else
+		int file = open(path.c_str(), O_RDONLY);
+
+		if (file == -1)
+			return false;
+
+		struct stat status = {};
+
+		if (fstat(file, &status) != 0 || status.st_size == 0)
+		{
+			close(file);
+
+			return false;
+		}
+
+		void* view = mmap(nullptr, (size_t)status.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0);
+
+		close(file);
+
+		if (view == MAP_FAILED)
+			return false;
+
+		Data = reinterpret_cast<const char*>(view);
+		Size = (size_t)status.st_size;
+#endif
+
+		return true;
+	}
+
+	void MappedFile::Close()
+	{
+		if (Data == nullptr)
+			return;
+
+#ifdef _WIN32
+		UnmapViewOfFile(Data);
+		CloseHandle(reinterpret_cast<HANDLE>(MappingHandle));
+		CloseHandle(reinterpret_cast<HANDLE>(FileHandle));
+#else
+		munmap(const_cast<char*>(Data), Size);
+#endif
+
+		Data = nullptr;
+		Size = 0;
+		FileHandle = nullptr;
+		MappingHandle = nullptr;
+	}
+}
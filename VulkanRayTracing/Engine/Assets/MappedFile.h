@@ -0,0 +1,30 @@
+#pragma once
+
+import <filesystem>;
+
+namespace Engine
+{
+	class MappedFile
+	{
+	public:
+		MappedFile() {}
+		MappedFile(const std::filesystem::path& path);
+		MappedFile(const MappedFile&) = delete;
+		~MappedFile();
+
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		bool Open(const std::filesystem::path& path);
+		void Close();
+
+		bool IsOpen() const { return Data != nullptr; }
+		const char* GetData() const { return Data; }
+		size_t GetSize() const { return Size; }
+
+	private:
+		const char* Data = nullptr;
+		size_t Size = 0;
+		void* FileHandle = nullptr;
+		void* MappingHandle = nullptr;
+	};
+}
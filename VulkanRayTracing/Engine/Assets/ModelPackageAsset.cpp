@@ -1,6 +1,7 @@
 #include "ModelPackageAsset.h"
 
 import <sstream>;
+import <set>;
 
 #include <Engine/VulkanGraphics/Scene/MeshAsset.h>
 #include <Engine/VulkanGraphics/Scene/MeshData.h>
@@ -8,9 +9,14 @@ import <sstream>;
 #include <Engine/VulkanGraphics/FileFormats/NifWriter.h>
 #include <Engine/VulkanGraphics/FileFormats/FbxParser.h>
 #include <Engine/VulkanGraphics/FileFormats/FbxWriter.h>
+#include <Engine/VulkanGraphics/FileFormats/PackageParser.h>
+#include <Engine/VulkanGraphics/FileFormats/PackageWriter.h>
 #include <Engine/Objects/Transform.h>
+#include "ModelPackageInstance.h"
 #include <Engine/VulkanGraphics/Scene/Scene.h>
 #include <Engine/VulkanGraphics/Scene/Model.h>
+#include <Engine/Assets/MappedFile.h>
+#include <Engine/Assets/ContentHash.h>
 
 namespace Engine
 {
@@ -24,15 +30,53 @@ namespace Engine
 		{
 			NifParser parser;
 			parser.Package = &Package;
-			parser.Parse(file);
+
+			std::shared_ptr<MappedFile> mappedFile = std::make_shared<MappedFile>();
+
+			if (mappedFile->Open(GetLoadedPath()))
+			{
+				parser.DataOwner = mappedFile;
+				parser.Parse(mappedFile->GetData(), mappedFile->GetSize());
+			}
+			else
+				parser.Parse(file);
 		}
 		else if (extension == FilePath(".fbx"))
 		{
 			FbxParser parser;
 
 			parser.Package = &Package;
-			parser.Parse(file);
+
+			// property data is read straight out of the mapping, so it has to outlive the parse
+			MappedFile mappedFile;
+
+			if (mappedFile.Open(GetLoadedPath()))
+				parser.Parse(mappedFile.GetData(), mappedFile.GetSize());
+			else
+				parser.Parse(file);
 		}
+		else if (extension == FilePath(".mpk"))
+		{
+			PackageParser parser;
+			parser.Package = &Package;
+
+			// vertex buffers stay in the mapping, so the meshes hold on to it
+			std::shared_ptr<MappedFile> mappedFile = std::make_shared<MappedFile>();
+
+			if (mappedFile->Open(GetLoadedPath()))
+			{
+				parser.DataOwner = mappedFile;
+				parser.Parse(mappedFile->GetData(), mappedFile->GetSize());
+			}
+			else
+				parser.Parse(file);
+		}
+
+		// the hierarchy gets built by whichever of the exporters or Instantiate needs it first
+		Package.ChildOffsets.clear();
+
+		if (OptimizeMeshes)
+			OptimizePackageMeshes();
 	}
 
 	void ModelPackageAsset::Saving(std::ostream& file, const FilePath& extension)
@@ -43,11 +87,18 @@ namespace Engine
 			writer.Package = &Package;
 			writer.Write(file);
 		}
+		if (extension == FilePath(".mpk"))
+		{
+			PackageWriter writer;
+			writer.Package = &Package;
+			writer.Write(file);
+		}
 		if (extension == FilePath(".fbx"))
 		{
 			FbxWriter writer;
 
 			writer.Package = &Package;
+			writer.Settings = FbxSettings;
 
 			for (size_t i = 0; i < ImportedMeshes.size(); ++i)
 			{
@@ -70,59 +121,93 @@ namespace Engine
 		}
 	}
 
+	void ModelPackageAsset::OptimizePackageMeshes()
+	{
+		std::set<Graphics::MeshData*> optimized;
+
+		OptimizationReports.clear();
+
+		// done once right after loading so both the exporters and the gpu buffers get the reordered mesh
+		for (size_t i = 0; i < Package.Nodes.size(); ++i)
+		{
+			std::shared_ptr<Graphics::MeshData>& mesh = Package.Nodes[i].Mesh;
+
+			if (mesh == nullptr || !optimized.insert(mesh.get()).second)
+				continue;
+
+			OptimizationReports.push_back(Optimizer.Optimize(*mesh));
+		}
+	}
+
 	void ModelPackageAsset::Unloading()
 	{
 
 	}
 
-	void ModelPackageAsset::Instantiate(std::shared_ptr<Transform>& parent, std::shared_ptr<Graphics::Scene>& scene)
+	std::shared_ptr<ModelPackageInstance> ModelPackageAsset::Instantiate(std::shared_ptr<Transform>& parent, std::shared_ptr<Graphics::Scene>& scene)
 	{
-		if (!IsLoaded()) return;
+		if (!IsLoaded()) return nullptr;
+
+		if (!Package.HasHierarchy())
+			Package.BuildHierarchy();
 
-		std::vector<std::shared_ptr<Transform>> transforms(Package.Nodes.size());
+		std::shared_ptr<ModelPackageInstance> instance = Engine::Create<ModelPackageInstance>();
 
+		instance->Name = Name;
+		instance->Configure(Cast<ModelPackageAsset>());
+		instance->SetParent(parent);
+
+		// only nodes with something drawn from them and their ancestors get a transform object, the rest stay in the instance's hierarchy
 		for (size_t j = 0; j < Package.Nodes.size(); ++j)
 		{
-			std::shared_ptr<Transform> transform = Engine::Create<Transform>();
+			if (Package.Nodes[j].Mesh == nullptr)
+				continue;
+
+			if (ImportedMeshes.size() <= j)
+				ImportedMeshes.resize(Package.Nodes.size());
 
-			transform->Name = Package.Nodes[j].Transform->Name;
-			transform->SetTransformation(Package.Nodes[j].Transform->GetTransformation());
+			std::shared_ptr<Graphics::MeshAsset> asset = ImportedMeshes[j];
 
-			if (Package.Nodes[j].Mesh != nullptr)
+			if (asset == nullptr)
 			{
-				if (ImportedMeshes.size() <= j)
-					ImportedMeshes.resize(Package.Nodes.size());
+				asset = Engine::Create<Graphics::MeshAsset>();
+				asset->SetMeshData(Package.Nodes[j].Mesh);
 
-				std::shared_ptr<Graphics::MeshAsset> asset = ImportedMeshes[j];
-				
-				if (asset == nullptr)
-				{
-					asset = Engine::Create<Graphics::MeshAsset>();
-					asset->SetMeshData(Package.Nodes[j].Mesh);
+				ImportedMeshes[j] = asset;
+			}
 
-					ImportedMeshes[j] = asset;
-				}
+			std::shared_ptr<Graphics::Model> model = Engine::Create<Graphics::Model>();
+			model->MeshAsset = asset;
+			model->SetParent(instance->GetNodeTransform(j));
 
-				std::shared_ptr<Graphics::Model> model = Engine::Create<Graphics::Model>();
-				model->MeshAsset = asset;
-				model->SetParent(transform);
+			asset->SetParent(model);
 
-				asset->SetParent(model);
+			scene->AddObject(model);
+		}
 
-				scene->AddObject(model);
-			}
+		instance->Update(0);
 
-			transforms[j] = transform;
-		}
+		return instance;
+	}
 
-		for (size_t j = 0; j < transforms.size(); ++j)
+	void ModelPackageAsset::HashExportSettings(ContentHash& hash, const FilePath& extension) const
+	{
+		hash.Push(extension.string());
+		hash.Push(OptimizeMeshes);
+
+		if (OptimizeMeshes)
 		{
-			if (Package.Nodes[j].AttachedTo == (size_t)-1)
-				transforms[j]->SetParent(parent);
-			else
-				transforms[j]->SetParent(transforms[Package.Nodes[j].AttachedTo]);
+			hash.Push(Optimizer.CacheSize);
+			hash.Push(Optimizer.OverdrawThreshold);
+			hash.Push(Optimizer.OptimizeOverdraw);
+			hash.Push(Optimizer.OptimizeVertexFetch);
+		}
 
-			transforms[j]->Update(0);
+		// only the fbx writer has settings that change its output
+		if (extension == FilePath(".fbx"))
+		{
+			hash.Push((int)FbxSettings.Compression);
+			hash.Push(FbxSettings.CompressionThreshold);
 		}
 	}
 }
\ No newline at end of file
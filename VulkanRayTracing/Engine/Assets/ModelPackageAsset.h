@@ -2,10 +2,14 @@
 
 #include "Asset.h"
 #include <Engine/VulkanGraphics/FileFormats/PackageNodes.h>
+#include <Engine/VulkanGraphics/FileFormats/FbxExportSettings.h>
+#include <Engine/VulkanGraphics/Scene/MeshOptimizer.h>
 
 namespace Engine
 {
 	class Transform;
+	class ContentHash;
+	class ModelPackageInstance;
 
 	namespace Graphics
 	{
@@ -16,6 +20,10 @@ namespace Engine
 	class ModelPackageAsset : public Asset
 	{
 	public:
+		FbxExportSettings FbxSettings;
+		bool OptimizeMeshes = false;
+		Graphics::MeshOptimizer Optimizer;
+
 		virtual void LoadDefault();
 		virtual void Loading(std::istream& file);
 		virtual void Saving(std::ostream& file, const FilePath& extension);
@@ -24,11 +32,16 @@ namespace Engine
 		const std::vector<std::shared_ptr<Graphics::MeshAsset>>& GetImportedMeshes() const { return ImportedMeshes; }
 		const std::vector<std::shared_ptr<Transform>>& GetMeshTransforms() const { return MeshTransforms; }
 		const Graphics::ModelPackage& GetPackage() const { return Package; }
-		void Instantiate(std::shared_ptr<Transform>& parent, std::shared_ptr<Graphics::Scene>& scene);
+		const std::vector<Graphics::MeshOptimizationReport>& GetOptimizationReports() const { return OptimizationReports; }
+		std::shared_ptr<ModelPackageInstance> Instantiate(std::shared_ptr<Transform>& parent, std::shared_ptr<Graphics::Scene>& scene);
+		void HashExportSettings(ContentHash& hash, const FilePath& extension) const;
 
 	private:
 		std::vector<std::shared_ptr<Graphics::MeshAsset>> ImportedMeshes;
 		std::vector<std::shared_ptr<Transform>> MeshTransforms;
 		Graphics::ModelPackage Package;
+		std::vector<Graphics::MeshOptimizationReport> OptimizationReports;
+
+		void OptimizePackageMeshes();
 	};
 }
\ No newline at end of file
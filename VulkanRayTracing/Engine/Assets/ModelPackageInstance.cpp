@@ -0,0 +1,123 @@
+#include "ModelPackageInstance.h"
+
+#include "ModelPackageAsset.h"
+
+namespace Engine
+{
+	void ModelPackageInstance::Configure(const std::shared_ptr<ModelPackageAsset>& asset)
+	{
+		Asset = asset;
+		Hierarchy = asset->GetPackage().Hierarchy;
+		Entries = asset->GetPackage().HierarchyEntries;
+		EntryNodes.assign(Hierarchy.GetCount(), 0);
+
+		for (size_t i = 0; i < Entries.size(); ++i)
+			EntryNodes[Entries[i]] = i;
+
+		EntryTransforms.clear();
+		EntryTransforms.resize(Hierarchy.GetCount());
+		AttachedEntries.clear();
+		HierarchyChanged = false;
+	}
+
+	void ModelPackageInstance::Update(Float delta)
+	{
+		UpdateHierarchy();
+
+		Transform::Update(delta);
+	}
+
+	void ModelPackageInstance::SetNodeTransformation(size_t node, const Matrix4& transformation)
+	{
+		size_t entry = GetEntry(node);
+
+		Hierarchy.Transformations[entry] = transformation;
+
+		if (EntryTransforms[entry] != nullptr)
+			EntryTransforms[entry]->SetTransformation(transformation);
+
+		HierarchyChanged = true;
+	}
+
+	const Matrix4& ModelPackageInstance::GetNodeTransformation(size_t node) const
+	{
+		size_t entry = GetEntry(node);
+
+		if (EntryTransforms[entry] != nullptr)
+			return EntryTransforms[entry]->GetTransformation();
+
+		return Hierarchy.Transformations[entry];
+	}
+
+	Matrix4 ModelPackageInstance::GetNodeWorldTransformation(size_t node)
+	{
+		UpdateHierarchy();
+
+		return GetWorldTransformation() * Hierarchy.WorldTransformations[GetEntry(node)];
+	}
+
+	std::shared_ptr<Transform> ModelPackageInstance::GetNodeTransform(size_t node)
+	{
+		size_t entry = GetEntry(node);
+
+		if (EntryTransforms[entry] != nullptr)
+			return EntryTransforms[entry];
+
+		// ancestors without an object get one too, so every object's parent stands in for its parent entry and its local transform maps straight onto the hierarchy
+		std::vector<size_t> chain;
+
+		for (size_t current = entry; current != TransformHierarchy::NoParent && EntryTransforms[current] == nullptr; current = Hierarchy.Parents[current])
+			chain.push_back(current);
+
+		for (; chain.size() > 0; chain.pop_back())
+		{
+			size_t current = chain.back();
+			size_t parent = Hierarchy.Parents[current];
+
+			const Graphics::ModelPackageNode& packageNode = Asset->GetPackage().Nodes[EntryNodes[current]];
+
+			std::shared_ptr<Transform> transform = Engine::Create<Transform>();
+
+			transform->Name = packageNode.Transform != nullptr ? packageNode.Transform->Name : packageNode.Name;
+			transform->SetTransformation(Hierarchy.Transformations[current]);
+			transform->SetParent(parent != TransformHierarchy::NoParent ? EntryTransforms[parent] : Cast<Transform>());
+
+			EntryTransforms[current] = transform;
+			AttachedEntries.push_back(current);
+		}
+
+		return EntryTransforms[entry];
+	}
+
+	size_t ModelPackageInstance::GetEntry(size_t node) const
+	{
+		if (node >= Entries.size())
+			throw "package instance node out of range";
+
+		return Entries[node];
+	}
+
+	void ModelPackageInstance::UpdateHierarchy()
+	{
+		// anything moved through its object gets read back first, so the flat arrays and the objects always describe the same pose
+		for (size_t i = 0; i < AttachedEntries.size(); ++i)
+		{
+			size_t entry = AttachedEntries[i];
+			const Matrix4& transformation = EntryTransforms[entry]->GetTransformation();
+
+			if (!(transformation == Hierarchy.Transformations[entry]))
+			{
+				Hierarchy.Transformations[entry] = transformation;
+
+				HierarchyChanged = true;
+			}
+		}
+
+		if (!HierarchyChanged)
+			return;
+
+		Hierarchy.Update();
+
+		HierarchyChanged = false;
+	}
+}
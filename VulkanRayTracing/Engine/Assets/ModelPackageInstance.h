@@ -0,0 +1,38 @@
+#pragma once
+
+#include <Engine/Objects/Transform.h>
+#include <Engine/Objects/TransformHierarchy.h>
+
+namespace Engine
+{
+	class ModelPackageAsset;
+
+	// one placed copy of a package. node transforms are kept in a flat hierarchy relative to this transform and Transform objects are only made for nodes something asks for, along with their ancestors.
+	// each of those holds its node's local transform under its parent node's object, so moving either the object or the node through SetNodeTransformation moves everything under it
+	class ModelPackageInstance : public Transform
+	{
+	public:
+		void Configure(const std::shared_ptr<ModelPackageAsset>& asset);
+		void Update(Float delta);
+
+		size_t GetNodeCount() const { return Hierarchy.GetCount(); }
+		size_t GetNodeTransformCount() const { return AttachedEntries.size(); }
+		void SetNodeTransformation(size_t node, const Matrix4& transformation);
+		const Matrix4& GetNodeTransformation(size_t node) const;
+		Matrix4 GetNodeWorldTransformation(size_t node);
+		std::shared_ptr<Transform> GetNodeTransform(size_t node);
+		const TransformHierarchy& GetHierarchy() const { return Hierarchy; }
+
+	private:
+		std::shared_ptr<ModelPackageAsset> Asset;
+		TransformHierarchy Hierarchy;
+		std::vector<size_t> Entries;
+		std::vector<size_t> EntryNodes;
+		std::vector<std::shared_ptr<Transform>> EntryTransforms;
+		std::vector<size_t> AttachedEntries;
+		bool HierarchyChanged = false;
+
+		size_t GetEntry(size_t node) const;
+		void UpdateHierarchy();
+	};
+}
@@ -0,0 +1,313 @@
+#pragma once
+
+import <algorithm>;
+import <atomic>;
+import <memory>;
+import <mutex>;
+import <vector>;
+
+namespace Engine
+{
+	// hands out 64 bit handles, the slot index in the low 32 bits and the slot's generation in the high 32. generations are odd while the slot is live and move on when it's
+	// released, so a stale handle is caught with one compare. each thread takes slots from its own shard, only growing and handing out shards ever takes a lock
+	template <typename T>
+	class HandleHeap
+	{
+	public:
+		typedef unsigned long long Handle;
+
+		static constexpr Handle NullHandle = 0;
+
+		HandleHeap() {}
+		~HandleHeap();
+
+		HandleHeap(const HandleHeap&) = delete;
+		HandleHeap& operator=(const HandleHeap&) = delete;
+
+		template <typename... Arguments>
+		Handle Acquire(Arguments&&... arguments);
+		void Release(Handle handle);
+		bool IsValid(Handle handle) const;
+		T* Get(Handle handle);
+		const T* Get(Handle handle) const;
+		size_t GetCapacity() const { return std::min(ChunkCount.load(std::memory_order_acquire), MaxChunks) * ChunkSize; }
+
+		static unsigned int GetIndex(Handle handle) { return (unsigned int)(handle & 0xFFFFFFFFull); }
+		static unsigned int GetGeneration(Handle handle) { return (unsigned int)(handle >> 32); }
+
+	private:
+		static constexpr size_t ChunkShift = 12;
+		static constexpr size_t ChunkSize = size_t(1) << ChunkShift;
+		static constexpr size_t MaxChunks = size_t(1) << 15;
+
+		struct Shard;
+
+		struct Slot
+		{
+			std::atomic<unsigned int> Generation = 0;
+			unsigned int NextFree = 0;
+			alignas(T) char Data[sizeof(T)];
+		};
+
+		struct Chunk
+		{
+			Shard* Owner = nullptr;
+			Slot Slots[ChunkSize];
+		};
+
+		// free slots are linked by index + 1 so 0 can end the list. slots released by other threads come back through Returned, which only its owner ever empties
+		struct Shard
+		{
+			unsigned int FreeHead = 0;
+			unsigned int NextFresh = 0;
+			unsigned int FreshEnd = 0;
+			std::atomic<unsigned int> Returned = 0;
+		};
+
+		struct ShardCache
+		{
+			HandleHeap* Heap = nullptr;
+			Shard* Owned = nullptr;
+
+			~ShardCache();
+		};
+
+		std::atomic<Chunk*> Chunks[MaxChunks] = {};
+		std::atomic<size_t> ChunkCount = 0;
+
+		std::mutex ShardMutex;
+		std::vector<std::unique_ptr<Shard>> Shards;
+		std::vector<Shard*> IdleShards;
+		Shard SharedShard;
+
+		static thread_local ShardCache LocalShard;
+
+		Shard* GetShard();
+		Slot* FindSlot(Handle handle) const;
+		unsigned int TakeIndex(Shard& shard);
+		void ReturnIndex(Shard* shard, Chunk* chunk, unsigned int index);
+		void AddChunk(Shard& shard);
+	};
+
+	template <typename T>
+	thread_local typename HandleHeap<T>::ShardCache HandleHeap<T>::LocalShard;
+
+	template <typename T>
+	HandleHeap<T>::~HandleHeap()
+	{
+		// other threads that took a shard have to be gone by now, heaps that live as long as the program are best left undestroyed
+		if (LocalShard.Heap == this)
+		{
+			LocalShard.Heap = nullptr;
+			LocalShard.Owned = nullptr;
+		}
+
+		for (size_t i = 0; i < std::min(ChunkCount.load(), MaxChunks); ++i)
+		{
+			Chunk* chunk = Chunks[i].load();
+
+			if (chunk == nullptr)
+				continue;
+
+			for (size_t j = 0; j < ChunkSize; ++j)
+				if (chunk->Slots[j].Generation.load() & 1)
+					reinterpret_cast<T*>(chunk->Slots[j].Data)->~T();
+
+			delete chunk;
+		}
+	}
+
+	template <typename T>
+	template <typename... Arguments>
+	typename HandleHeap<T>::Handle HandleHeap<T>::Acquire(Arguments&&... arguments)
+	{
+		Shard* shard = GetShard();
+		unsigned int index = 0;
+
+		if (shard != nullptr)
+			index = TakeIndex(*shard);
+		else
+		{
+			std::lock_guard<std::mutex> lock(ShardMutex);
+
+			index = TakeIndex(SharedShard);
+		}
+
+		Slot& slot = Chunks[index >> ChunkShift].load(std::memory_order_acquire)->Slots[index & (ChunkSize - 1)];
+
+		::new (reinterpret_cast<T*>(slot.Data)) T(std::forward<Arguments>(arguments)...);
+
+		unsigned int generation = slot.Generation.load(std::memory_order_relaxed) + 1;
+
+		slot.Generation.store(generation, std::memory_order_release);
+
+		return (Handle(generation) << 32) | index;
+	}
+
+	template <typename T>
+	void HandleHeap<T>::Release(Handle handle)
+	{
+		Slot* slot = FindSlot(handle);
+
+		if (slot == nullptr)
+			return;
+
+		unsigned int index = GetIndex(handle);
+		Chunk* chunk = Chunks[index >> ChunkShift].load(std::memory_order_acquire);
+
+		reinterpret_cast<T*>(slot->Data)->~T();
+		slot->Generation.store(GetGeneration(handle) + 1, std::memory_order_release);
+
+		Shard* shard = GetShard();
+
+		if (shard == nullptr && chunk->Owner == &SharedShard)
+		{
+			std::lock_guard<std::mutex> lock(ShardMutex);
+
+			ReturnIndex(&SharedShard, chunk, index);
+		}
+		else
+			ReturnIndex(shard, chunk, index);
+	}
+
+	template <typename T>
+	bool HandleHeap<T>::IsValid(Handle handle) const
+	{
+		return FindSlot(handle) != nullptr;
+	}
+
+	template <typename T>
+	T* HandleHeap<T>::Get(Handle handle)
+	{
+		Slot* slot = FindSlot(handle);
+
+		return slot != nullptr ? reinterpret_cast<T*>(slot->Data) : nullptr;
+	}
+
+	template <typename T>
+	const T* HandleHeap<T>::Get(Handle handle) const
+	{
+		return const_cast<HandleHeap*>(this)->Get(handle);
+	}
+
+	template <typename T>
+	typename HandleHeap<T>::Shard* HandleHeap<T>::GetShard()
+	{
+		ShardCache& cache = LocalShard;
+
+		if (cache.Heap == this)
+			return cache.Owned;
+
+		// a thread's shard belongs to the first heap of this type it touches, any other heap of the same type falls back to a locked shared shard
+		if (cache.Heap != nullptr)
+			return nullptr;
+
+		std::lock_guard<std::mutex> lock(ShardMutex);
+
+		if (IdleShards.size() > 0)
+		{
+			cache.Owned = IdleShards.back();
+			IdleShards.pop_back();
+		}
+		else
+		{
+			Shards.push_back(std::make_unique<Shard>());
+			cache.Owned = Shards.back().get();
+		}
+
+		cache.Heap = this;
+
+		return cache.Owned;
+	}
+
+	template <typename T>
+	HandleHeap<T>::ShardCache::~ShardCache()
+	{
+		// the shard keeps its free slots and anything still being returned to it, the next thread to come along picks it up
+		if (Heap == nullptr)
+			return;
+
+		std::lock_guard<std::mutex> lock(Heap->ShardMutex);
+
+		Heap->IdleShards.push_back(Owned);
+	}
+
+	template <typename T>
+	typename HandleHeap<T>::Slot* HandleHeap<T>::FindSlot(Handle handle) const
+	{
+		unsigned int index = GetIndex(handle);
+		unsigned int generation = GetGeneration(handle);
+
+		if ((generation & 1) == 0 || (index >> ChunkShift) >= MaxChunks)
+			return nullptr;
+
+		Chunk* chunk = Chunks[index >> ChunkShift].load(std::memory_order_acquire);
+
+		if (chunk == nullptr)
+			return nullptr;
+
+		Slot& slot = chunk->Slots[index & (ChunkSize - 1)];
+
+		return slot.Generation.load(std::memory_order_acquire) == generation ? &slot : nullptr;
+	}
+
+	template <typename T>
+	unsigned int HandleHeap<T>::TakeIndex(Shard& shard)
+	{
+		if (shard.FreeHead == 0)
+			shard.FreeHead = shard.Returned.exchange(0, std::memory_order_acquire);
+
+		if (shard.FreeHead != 0)
+		{
+			unsigned int index = shard.FreeHead - 1;
+
+			shard.FreeHead = Chunks[index >> ChunkShift].load(std::memory_order_relaxed)->Slots[index & (ChunkSize - 1)].NextFree;
+
+			return index;
+		}
+
+		if (shard.NextFresh == shard.FreshEnd)
+			AddChunk(shard);
+
+		return shard.NextFresh++;
+	}
+
+	template <typename T>
+	void HandleHeap<T>::ReturnIndex(Shard* shard, Chunk* chunk, unsigned int index)
+	{
+		Slot& slot = chunk->Slots[index & (ChunkSize - 1)];
+
+		if (shard == chunk->Owner)
+		{
+			slot.NextFree = shard->FreeHead;
+			shard->FreeHead = index + 1;
+
+			return;
+		}
+
+		// the owner takes the whole list at once, so pushing only has to race other pushes
+		std::atomic<unsigned int>& returned = chunk->Owner->Returned;
+		unsigned int head = returned.load(std::memory_order_relaxed);
+
+		do
+			slot.NextFree = head;
+		while (!returned.compare_exchange_weak(head, index + 1, std::memory_order_release, std::memory_order_relaxed));
+	}
+
+	template <typename T>
+	void HandleHeap<T>::AddChunk(Shard& shard)
+	{
+		size_t chunkIndex = ChunkCount.fetch_add(1, std::memory_order_relaxed);
+
+		if (chunkIndex >= MaxChunks)
+			throw "handle heap is full";
+
+		Chunk* chunk = new Chunk();
+
+		chunk->Owner = &shard;
+		Chunks[chunkIndex].store(chunk, std::memory_order_release);
+
+		shard.NextFresh = (unsigned int)(chunkIndex << ChunkShift);
+		shard.FreshEnd = shard.NextFresh + (unsigned int)ChunkSize;
+	}
+}
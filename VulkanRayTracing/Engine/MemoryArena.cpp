@@ -0,0 +1,150 @@
+#include "MemoryArena.h"
+
+import <cstring>;
+import <cstdint>;
+import <new>;
+
+namespace Engine
+{
+	char* AlignPointer(char* pointer, size_t alignment)
+	{
+		return reinterpret_cast<char*>((reinterpret_cast<std::uintptr_t>(pointer) + alignment - 1) & ~(std::uintptr_t)(alignment - 1));
+	}
+
+	thread_local MemoryArena* MemoryArena::ScopedArena = nullptr;
+
+	MemoryArena::Scope::Scope(MemoryArena& arena) : Previous(ScopedArena)
+	{
+		ScopedArena = &arena;
+	}
+
+	MemoryArena::Scope::~Scope()
+	{
+		ScopedArena = Previous;
+	}
+
+	std::pmr::memory_resource* MemoryArena::GetScoped()
+	{
+		if (ScopedArena != nullptr)
+			return ScopedArena;
+
+		return std::pmr::new_delete_resource();
+	}
+
+	MemoryArena::MemoryArena(size_t blockSize) : BlockSize(blockSize)
+	{
+	}
+
+	MemoryArena::~MemoryArena()
+	{
+		Release();
+	}
+
+	std::string_view MemoryArena::Copy(std::string_view text)
+	{
+		if (text.size() == 0)
+			return std::string_view();
+
+		char* data = nullptr;
+
+		// copies have no container to hand them back when forwarding to the heap, so they're kept until the release
+		if (BlockSize == 0)
+		{
+			Copies.push_back(std::make_unique<char[]>(text.size()));
+
+			data = Copies.back().get();
+
+			++AllocationCount;
+			++BlockCount;
+			BytesAllocated += text.size();
+			BytesReserved += text.size();
+		}
+		else
+			data = reinterpret_cast<char*>(allocate(text.size(), 1));
+
+		std::memcpy(data, text.data(), text.size());
+
+		return std::string_view(data, text.size());
+	}
+
+	void MemoryArena::Release()
+	{
+		while (Blocks != nullptr)
+		{
+			Block* previous = Blocks->Previous;
+
+			::operator delete(Blocks);
+
+			Blocks = previous;
+		}
+
+		Copies.clear();
+		Cursor = nullptr;
+		End = nullptr;
+		AllocationCount = 0;
+		BlockCount = 0;
+		BytesAllocated = 0;
+		BytesReserved = 0;
+	}
+
+	void* MemoryArena::do_allocate(size_t size, size_t alignment)
+	{
+		++AllocationCount;
+		BytesAllocated += size;
+
+		if (BlockSize == 0)
+		{
+			++BlockCount;
+			BytesReserved += size;
+
+			return std::pmr::new_delete_resource()->allocate(size, alignment);
+		}
+
+		char* data = AlignPointer(Cursor, alignment);
+
+		if (Cursor != nullptr && (size_t)(data - Cursor) + size <= (size_t)(End - Cursor))
+		{
+			Cursor = data + size;
+
+			return data;
+		}
+
+		// big requests get a block of their own so they don't throw away what's left of the current one
+		if (size + alignment > BlockSize / 4)
+			return AlignPointer(AddBlock(size + alignment), alignment);
+
+		Cursor = AddBlock(BlockSize);
+		End = Cursor + BlockSize;
+
+		data = AlignPointer(Cursor, alignment);
+		Cursor = data + size;
+
+		return data;
+	}
+
+	void MemoryArena::do_deallocate(void* data, size_t size, size_t alignment)
+	{
+		if (BlockSize == 0)
+			std::pmr::new_delete_resource()->deallocate(data, size, alignment);
+	}
+
+	bool MemoryArena::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+	{
+		return this == &other;
+	}
+
+	char* MemoryArena::AddBlock(size_t size)
+	{
+		// the header is padded out so the block's memory starts fully aligned
+		const size_t headerSize = (sizeof(Block) + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+
+		Block* block = new (::operator new(headerSize + size)) Block{ Blocks, size };
+
+		Blocks = block;
+
+		++BlockCount;
+		BytesReserved += size;
+
+		return reinterpret_cast<char*>(block) + headerSize;
+	}
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+import <memory_resource>;
+import <string_view>;
+import <vector>;
+import <memory>;
+
+namespace Engine
+{
+	// bump allocates out of large blocks and gives them all back at once, individual deallocations are ignored. a block size of 0 forwards every request to the heap instead, which is only there to compare against
+	class MemoryArena : public std::pmr::memory_resource
+	{
+	public:
+		static const size_t DefaultBlockSize = 1 << 16;
+
+		MemoryArena(size_t blockSize = DefaultBlockSize);
+		~MemoryArena();
+
+		MemoryArena(const MemoryArena&) = delete;
+		MemoryArena& operator=(const MemoryArena&) = delete;
+
+		class Scope
+		{
+		public:
+			Scope(MemoryArena& arena);
+			~Scope();
+
+			Scope(const Scope&) = delete;
+			Scope& operator=(const Scope&) = delete;
+
+		private:
+			MemoryArena* Previous = nullptr;
+		};
+
+		std::string_view Copy(std::string_view text);
+		void Release();
+
+		static std::pmr::memory_resource* GetScoped();
+
+		bool IsBumpAllocating() const { return BlockSize != 0; }
+		size_t GetAllocationCount() const { return AllocationCount; }
+		size_t GetBlockCount() const { return BlockCount; }
+		size_t GetBytesAllocated() const { return BytesAllocated; }
+		size_t GetBytesReserved() const { return BytesReserved; }
+
+	protected:
+		void* do_allocate(size_t size, size_t alignment) override;
+		void do_deallocate(void* data, size_t size, size_t alignment) override;
+		bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+	private:
+		struct Block
+		{
+			Block* Previous = nullptr;
+			size_t Size = 0;
+		};
+
+		size_t BlockSize = 0;
+		Block* Blocks = nullptr;
+		char* Cursor = nullptr;
+		char* End = nullptr;
+		std::vector<std::unique_ptr<char[]>> Copies;
+
+		size_t AllocationCount = 0;
+		size_t BlockCount = 0;
+		size_t BytesAllocated = 0;
+		size_t BytesReserved = 0;
+
+		static thread_local MemoryArena* ScopedArena;
+
+		char* AddBlock(size_t size);
+	};
+
+	// for containers that get default constructed deep inside other objects. they pick up whatever arena is scoped on the constructing thread, or the heap when there isn't one
+	template <typename T>
+	class ArenaAllocator
+	{
+	public:
+		typedef T value_type;
+
+		ArenaAllocator() : Resource(MemoryArena::GetScoped()) {}
+		ArenaAllocator(std::pmr::memory_resource* resource) : Resource(resource) {}
+
+		template <typename Other>
+		ArenaAllocator(const ArenaAllocator<Other>& other) : Resource(other.GetResource()) {}
+
+		T* allocate(size_t count) { return static_cast<T*>(Resource->allocate(count * sizeof(T), alignof(T))); }
+		void deallocate(T* data, size_t count) { Resource->deallocate(data, count * sizeof(T), alignof(T)); }
+
+		ArenaAllocator select_on_container_copy_construction() const { return ArenaAllocator(); }
+		std::pmr::memory_resource* GetResource() const { return Resource; }
+
+		template <typename Other>
+		bool operator==(const ArenaAllocator<Other>& other) const { return Resource == other.GetResource(); }
+
+	private:
+		std::pmr::memory_resource* Resource = nullptr;
+	};
+}
@@ -2,27 +2,30 @@
 
 import <iostream>;
 
-#include <Engine/IdentifierHeap.h>
+#include <Engine/HandleHeap.h>
 #include <Engine/Reflection/MetaData.h>
 
 namespace Engine
 {
-	typedef IDHeap<Object::ObjectHandleData> ObjectHandleHeap;
+	typedef HandleHeap<Object::ObjectHandleData> ObjectHandleHeap;
 
-	ObjectHandleHeap ObjectIDs;
+	ObjectHandleHeap& GetObjectIDs()
+	{
+		// never destroyed, objects and worker threads that outlive static destruction still hand their ids and shards back to it
+		static ObjectHandleHeap* objectIDs = new ObjectHandleHeap();
 
-	unsigned long long Object::ObjectsCreated = 0;
+		return *objectIDs;
+	}
 
 	void Object::Initialize()
 	{
-		ObjectID = ObjectIDs.RequestID(ObjectHandleData{ this, This, ++ObjectsCreated });
+		ObjectID = GetObjectIDs().Acquire(ObjectHandleData{ this, This });
 		OriginalID = ObjectID;
-		CreationOrderId = ObjectsCreated;
 	}
 
-	bool Object::IsAlive(int objectId, unsigned long long creationOrderId)
+	bool Object::IsAlive(unsigned long long objectId)
 	{
-		return ObjectIDs.NodeAllocated(objectId) && ObjectIDs.GetNode(objectId).GetData().CreationOrderId == creationOrderId;
+		return GetObjectIDs().IsValid(objectId);
 	}
 
 	std::string Object::GetTypeName() const
@@ -51,18 +54,18 @@ namespace Engine
 		return data == metadata || data->InheritsType(metadata);
 	}
 
-	void Object::SetObjectID(int id)
+	void Object::SetObjectID(unsigned long long id)
 	{
-		if (ObjectID != -1)
+		if (ObjectID != 0)
 			throw "Attempt to set ID";
 
 		ObjectID = id;
 
-		if (id != -1)
+		if (id != 0)
 			OriginalID = id;
 	}
 
-	int Object::GetObjectID() const
+	unsigned long long Object::GetObjectID() const
 	{
 		return ObjectID;
 	}
@@ -98,7 +101,7 @@ namespace Engine
 			Children.pop_back();
 		}
 
-		ObjectIDs.Release(ObjectID);
+		GetObjectIDs().Release(ObjectID);
 	}
 
 	std::string Object::GetFullName() const
@@ -371,8 +374,13 @@ namespace Engine
 		return type == target || (inherited && type->InheritsType(target));
 	}
 
-	const std::weak_ptr<Object>& Object::GetHandle(int id)
+	const std::weak_ptr<Object>& Object::GetHandle(unsigned long long id)
 	{
-		return ObjectIDs.GetNode(id).GetData().SmartPointer;
+		ObjectHandleData* data = GetObjectIDs().Get(id);
+
+		if (data == nullptr)
+			throw "Attempt to access unallocated ID";
+
+		return data->SmartPointer;
 	}
 }
@@ -42,8 +42,8 @@ namespace Engine
 		bool IsA(const std::string& className, bool inherited = true) const;
 		bool IsA(const Meta::ReflectedType* type, bool inherited = true) const;
 
-		void SetObjectID(int id);
-		int GetObjectID() const;
+		void SetObjectID(unsigned long long id);
+		unsigned long long GetObjectID() const;
 
 		template <typename T>
 		bool IsA(bool inherited = true);
@@ -57,7 +57,7 @@ namespace Engine
 		operator std::string() const;
 
 		template <typename T = Object>
-		static std::shared_ptr<T> GetObjectFromID(int id);
+		static std::shared_ptr<T> GetObjectFromID(unsigned long long id);
 
 		std::string GetFullName() const;
 		int GetChildren() const;
@@ -105,9 +105,7 @@ namespace Engine
 		template <typename T>
 		bool HasA(bool inherited = true);
 
-		const unsigned long long& GetCreationOrderId() const { return CreationOrderId; }
-
-		static bool IsAlive(int objectID, unsigned long long creationOrderId);
+		static bool IsAlive(unsigned long long objectID);
 
 		const Meta::ReflectedType* GetMetaData() const
 		{
@@ -127,17 +125,13 @@ namespace Engine
 		{
 			Object* Data = nullptr;
 			std::weak_ptr<Object> SmartPointer;
-			unsigned long long CreationOrderId = 0;
 		};
 
 	private:
 		typedef std::vector<std::shared_ptr<Object>> ObjectVector;
 
-		static unsigned long long ObjectsCreated;
-
-		int ObjectID = -1;
-		int OriginalID = -1;
-		unsigned long long CreationOrderId = 0;
+		unsigned long long ObjectID = 0;
+		unsigned long long OriginalID = 0;
 		bool Ticks = false;
 		int TickingChildren = 0;
 		bool TickedBefore = false;
@@ -151,7 +145,7 @@ namespace Engine
 
 		static bool MetaMatches(const Meta::ReflectedType* type, const Meta::ReflectedType* target, bool inherited);
 
-		static const std::weak_ptr<Object>& GetHandle(int id);
+		static const std::weak_ptr<Object>& GetHandle(unsigned long long id);
 	};
 
 	template <typename T>
@@ -270,9 +264,9 @@ namespace Engine
 	}
 
 	template <typename T>
-	std::shared_ptr<T> Object::GetObjectFromID(int id)
+	std::shared_ptr<T> Object::GetObjectFromID(unsigned long long id)
 	{
-		if (id != -1)
+		if (id != 0)
 			return GetHandle(id).lock()->Cast<T>();
 
 		return nullptr;
@@ -6,8 +6,6 @@ namespace Engine
 	{
 		Object::Update(delta);
 
-		Recompute(true);
-
 		//if (Moved)
 		//	TransformMoved.Fire(this);
 
@@ -17,71 +15,85 @@ namespace Engine
 			SetTicks(false);
 	}
 
-	void Transform::Recompute(bool doUpdate)
+	void Transform::ParentChanged(std::shared_ptr<Object> newParent)
 	{
-		if (!doUpdate && !HasChanged())
-			return;
+		MarkChanged();
+	}
 
+	void Transform::MarkChanged()
+	{
 		Moved = true;
 
+		if (!DoesObjectTick())
+			SetTicks(true);
+
+		if (WorldStale)
+			return;
+
+		WorldStale = true;
+
+		// transforms that don't inherit can't be affected, and ones that are already stale have stale subtrees
+		std::vector<Object*> pending(1, this);
+
+		while (pending.size() > 0)
+		{
+			Object* object = pending.back();
+
+			pending.pop_back();
+
+			for (int i = 0; i < object->GetChildren(); ++i)
+			{
+				Object* child = object->Get(i).get();
+				Transform* transform = dynamic_cast<Transform*>(child);
+
+				if (transform != nullptr)
+				{
+					if (transform->WorldStale || !transform->InheritTransformation)
+						continue;
+
+					// Moved stays on the edited transform only, since that's the one ticking to clear it. HasMoved walks the parents to find it
+					transform->WorldStale = true;
+				}
+
+				pending.push_back(child);
+			}
+		}
+	}
+
+	void Transform::Recompute() const
+	{
+		if (!WorldStale)
+			return;
+
 		const Transform* inherited = nullptr;
 
 		if (InheritTransformation)
-			inherited = GetComponent<Transform>(true).get();
-
-		HadParent = InheritTransformation && inherited != nullptr;
+			inherited = GetComponent2<Transform>(true);
 
 		if (inherited == nullptr)
 			WorldTransformation = Transformation;
 		else
 			WorldTransformation = inherited->GetWorldTransformation() * Transformation;
 
-		WorldTransformationInverse.Invert(WorldTransformation);
-		WorldNormalTransformation = WorldTransformation.Inverted().Transpose();
-		WorldRotation = Matrix4(true).ExtractRotation(WorldTransformation);
-
-		if (HadParent)
-			OldParentTransform = inherited->GetWorldTransformation();
-
-		SetTicks(true);
+		WorldStale = false;
+		InverseStale = true;
+		RotationStale = true;
+		NormalStale = true;
 	}
 
 	bool Transform::HasMoved() const
 	{
 		if (Moved)
 			return true;
-		else if (InheritTransformation)
-		{
-			std::shared_ptr<Transform> parent = GetComponent<Transform>();
 
-			if (parent != nullptr && parent->HasMoved())
-				return true;
-		}
+		const Transform* parent = InheritTransformation ? GetComponent2<Transform>() : nullptr;
 
-		return InheritTransformation && HadParent;
+		return parent != nullptr && parent->HasMoved();
 	}
 
 	bool Transform::HasMoved()
 	{
-		if (Moved)
-			return true;
-		else if (InheritTransformation)
-		{
-			std::shared_ptr<Transform> parent = GetComponent<Transform>();
-
-			if (parent != nullptr && parent->HasMoved())
-			{
-				Moved = true;
-				HadParent = true;
-
-				return true;
-			}
-		}
-
-		Moved = InheritTransformation && HadParent;
-		HadParent = false;
-
-		return Moved;
+		return static_cast<const Transform*>(this)->HasMoved();
 	}
 
 	void Transform::SetStatic(bool isStatic)
@@ -100,9 +112,7 @@ namespace Engine
 	{
 		Transformation = matrix;
 
-		Moved = true;
-
-		Recompute();
+		MarkChanged();
 	}
 
 	const Matrix4& Transform::GetTransformation()
@@ -114,7 +124,7 @@ namespace Engine
 	{
 		InheritTransformation = inherits;
 
-		Recompute();
+		MarkChanged();
 	}
 
 	bool Transform::InheritsTransformation() const
@@ -122,23 +132,6 @@ namespace Engine
 		return InheritTransformation;
 	}
 
-	bool Transform::HasChanged()
-	{
-		if (InheritTransformation)
-		{
-			std::shared_ptr<Transform> parent = GetComponent<Transform>();
-
-			bool hasParent = parent != nullptr;
-
-			if (hasParent != HadParent)
-				return true;
-			else if (hasParent && parent->GetWorldTransformation() != OldParentTransform)
-				return true;
-		}
-
-		return Moved;
-	}
-
 	Vector3 Transform::GetPosition() const
 	{
 		return Transformation.Translation();
@@ -146,98 +139,112 @@ namespace Engine
 
 	Vector3 Transform::GetPosition()
 	{
-		if (Moved || InheritTransformation)
-			Recompute();
-
 		return Transformation.Translation();
 	}
 
 	void Transform::SetPosition(const Vector3& position)
 	{
 		Transformation.SetTranslation(position);
+
+		MarkChanged();
 	}
 
 	void Transform::Move(const Vector3& offset)
 	{
 		Transformation.SetTranslation(Transformation.Translation() + offset);
+
+		MarkChanged();
 	}
 
 	Vector3 Transform::GetWorldPosition() const
 	{
-		return WorldTransformation.Translation();
+		return GetWorldTransformation().Translation();
 	}
 
 	Vector3 Transform::GetWorldPosition()
 	{
-		if (Moved || InheritTransformation)
-			Recompute();
-		
-		return WorldTransformation.Translation();
+		return GetWorldTransformation().Translation();
 	}
 
 	const Matrix4& Transform::GetWorldTransformation() const
 	{
+		Recompute();
+
 		return WorldTransformation;
 	}
 
 	const Matrix4& Transform::GetWorldTransformation()
 	{
-		if (Moved || InheritTransformation)
-			Recompute();
-		
+		Recompute();
+
 		return WorldTransformation;
 	}
 
 	const Matrix4& Transform::GetWorldTransformationInverse() const
 	{
+		Recompute();
+
+		if (InverseStale)
+		{
+			WorldTransformationInverse.Invert(WorldTransformation);
+
+			InverseStale = false;
+		}
+
 		return WorldTransformationInverse;
 	}
 
 	const Matrix4& Transform::GetWorldTransformationInverse()
 	{
-		if (Moved || InheritTransformation)
-			Recompute();
-
-		return WorldTransformationInverse;
+		return static_cast<const Transform*>(this)->GetWorldTransformationInverse();
 	}
 
 	const Matrix4& Transform::GetWorldRotation() const
 	{
+		Recompute();
+
+		if (RotationStale)
+		{
+			WorldRotation = Matrix4(true).ExtractRotation(WorldTransformation);
+
+			RotationStale = false;
+		}
+
 		return WorldRotation;
 	}
 
 	const Matrix4& Transform::GetWorldRotation()
 	{
-		if (Moved || InheritTransformation)
-			Recompute();
-
-		return WorldRotation;
+		return static_cast<const Transform*>(this)->GetWorldRotation();
 	}
 
 	Quaternion Transform::GetWorldOrientation() const
 	{
-		return Quaternion(WorldTransformation);
+		return Quaternion(GetWorldTransformation());
 	}
 
 	Quaternion Transform::GetWorldOrientation()
 	{
-		if (Moved || InheritTransformation)
-			Recompute();
-
-		return Quaternion(WorldTransformation);
+		return Quaternion(GetWorldTransformation());
 	}
 
 	const Matrix4& Transform::GetWorldNormalTransformation() const
 	{
+		Recompute();
+
+		if (NormalStale)
+		{
+			WorldNormalTransformation = GetWorldTransformationInverse().Transposed();
+
+			NormalStale = false;
+		}
+
 		return WorldNormalTransformation;
 	}
 
 	const Matrix4& Transform::GetWorldNormalTransformation()
 	{
-		if (Moved || InheritTransformation)
-			Recompute();
-
-		return WorldNormalTransformation;
+		return static_cast<const Transform*>(this)->GetWorldNormalTransformation();
 	}
 
 	Quaternion Transform::GetOrientation() const
@@ -247,15 +254,14 @@ namespace Engine
 
 	Quaternion Transform::GetOrientation()
 	{
-		if (Moved || InheritTransformation)
-			Recompute();
-
 		return Quaternion(Transformation);
 	}
 
 	void Transform::SetOrientation(const Quaternion& orientation)
 	{
 		Transformation = Matrix4(orientation).SetTranslation(Transformation.Translation());
+
+		MarkChanged();
 	}
 
 	void Transform::Rotate(const Quaternion& rotation)
@@ -265,6 +271,8 @@ namespace Engine
 		Transformation.SetTranslation(Vector3());
 		
 		Transformation = (Matrix4(rotation) * Transformation).SetTranslation(translation);
+
+		MarkChanged();
 	}
 
 	void Transform::Rotate(const Vector3& axis, float angle)
@@ -274,6 +282,8 @@ namespace Engine
 		Transformation.SetTranslation(Vector3());
 
 		Transformation = (Matrix4(true).RotateAxis(axis, angle) * Transformation).SetTranslation(translation);
+
+		MarkChanged();
 	}
 
 	Vector3 Transform::GetEulerAngles() const
@@ -283,20 +293,21 @@ namespace Engine
 
 	Vector3 Transform::GetEulerAngles()
 	{
-		if (Moved || InheritTransformation)
-			Recompute();
-
 		return Vector3();
 	}
 
 	void Transform::SetEulerAngles(const Vector3& angles)
 	{
 		Transformation = Matrix4::EulerAnglesRotation(angles.X, angles.Y, angles.Z).SetTranslation(Transformation.Translation());
+
+		MarkChanged();
 	}
 
 	void Transform::SetEulerAngles(float pitch, float roll, float yaw)
 	{
 		Transformation = Matrix4::EulerAnglesRotation(pitch, roll, yaw).SetTranslation(Transformation.Translation());
+
+		MarkChanged();
 	}
 
 	void Transform::Rotate(const Vector3& angles)
@@ -306,6 +317,8 @@ namespace Engine
 		Transformation.SetTranslation(Vector3());
 
 		Transformation = (Matrix4::EulerAnglesRotation(angles.X, angles.Y, angles.Z) * Transformation).SetTranslation(translation);
+
+		MarkChanged();
 	}
 
 	void Transform::Rotate(float pitch, float roll, float yaw)
@@ -315,6 +328,8 @@ namespace Engine
 		Transformation.SetTranslation(Vector3());
 
 		Transformation = (Matrix4::EulerAnglesRotation(pitch, roll, yaw) * Transformation).SetTranslation(translation);
+
+		MarkChanged();
 	}
 
 	Vector3 Transform::GetEulerAnglesYaw() const
@@ -324,20 +339,21 @@ namespace Engine
 
 	Vector3 Transform::GetEulerAnglesYaw()
 	{
-		if (Moved || InheritTransformation)
-			Recompute();
-
 		return Vector3();
 	}
 
 	void Transform::SetEulerAnglesYaw(float yaw, float pitch, float roll)
 	{
 		Transformation = Matrix4::EulerAnglesYawRotation(yaw, pitch, roll).SetTranslation(Transformation.Translation());
+
+		MarkChanged();
 	}
 
 	void Transform::SetEulerAnglesYaw(const Vector3& angles)
 	{
 		Transformation = Matrix4::EulerAnglesYawRotation(angles.X, angles.Y, angles.Z).SetTranslation(Transformation.Translation());
+
+		MarkChanged();
 	}
 
 	void Transform::RotateYaw(const Vector3& angles)
@@ -347,6 +363,8 @@ namespace Engine
 		Transformation.SetTranslation(Vector3());
 
 		Transformation = (Matrix4::EulerAnglesYawRotation(angles.X, angles.Y, angles.Z) * Transformation).SetTranslation(translation);
+
+		MarkChanged();
 	}
 
 	void Transform::RotateYaw(float yaw, float pitch, float roll)
@@ -356,6 +374,8 @@ namespace Engine
 		Transformation.SetTranslation(Vector3());
 
 		Transformation = (Matrix4::EulerAnglesYawRotation(yaw, pitch, roll) * Transformation).SetTranslation(translation);
+
+		MarkChanged();
 	}
 
 	Vector3 Transform::GetScale() const
@@ -365,9 +385,6 @@ namespace Engine
 
 	Vector3 Transform::GetScale()
 	{
-		if (Moved || InheritTransformation)
-			Recompute();
-
 		return Vector3(Transformation.RightVector().Length(), Transformation.UpVector().Length(), Transformation.FrontVector().Length());
 	}
 
@@ -376,6 +393,8 @@ namespace Engine
 		Transformation.SetRight(Transformation.RightVector().Normalize() * scale.X);
 		Transformation.SetUp(Transformation.UpVector().Normalize() * scale.Y);
 		Transformation.SetFront(Transformation.FrontVector().Normalize() * scale.Z);
+
+		MarkChanged();
 	}
 
 	void Transform::Rescale(const Vector3& scale)
@@ -383,16 +402,22 @@ namespace Engine
 		Transformation.SetRight(Transformation.RightVector() * scale.X);
 		Transformation.SetUp(Transformation.UpVector() * scale.Y);
 		Transformation.SetFront(Transformation.FrontVector() * scale.Z);
+
+		MarkChanged();
 	}
 
 	void Transform::TransformBy(const Matrix4& transformation)
 	{
 		Transformation = transformation * Transformation;
+
+		MarkChanged();
 	}
 
 	void Transform::TransformBy(const Quaternion& transformation, const Vector3& point)
 	{
 		Transformation = Matrix4(transformation).SetTranslation(point) * Transformation;
+
+		MarkChanged();
 	}
 
 	void Transform::TransformByRelative(const Matrix4& transformation)
@@ -402,6 +427,8 @@ namespace Engine
 		Transformation.SetTranslation(Vector3());
 
 		Transformation = (transformation * Transformation).SetTranslation(translation);
+
+		MarkChanged();
 	}
 
 	void Transform::TransformByRelative(const Quaternion& transformation, const Vector3& point)
@@ -411,5 +438,7 @@ namespace Engine
 		Transformation.SetTranslation(Vector3());
 
 		Transformation = (Matrix4(transformation).SetTranslation(point) * Transformation).SetTranslation(translation);
+
+		MarkChanged();
 	}
 }
@@ -13,6 +13,7 @@ namespace Engine
 		virtual ~Transform() {}
 
 		void Update(Float delta);
+		void ParentChanged(std::shared_ptr<Object> newParent);
 
 		bool HasMoved() const;
 		bool HasMoved();
@@ -77,19 +78,23 @@ namespace Engine
 		//Event<Transform*> TransformMoved;
 
 	private:
+		// everything derived from the world transformation is rebuilt on the first read after it goes stale, edits only flag it.
+		// a stale transform always has stale transforms below it, so flagging a subtree stops at the first one that already is
 		Matrix4 Transformation;
-		Matrix4 WorldTransformation;
-		Matrix4 WorldTransformationInverse;
-		Matrix4 WorldRotation;
-		Matrix4 WorldNormalTransformation;
+		mutable Matrix4 WorldTransformation;
+		mutable Matrix4 WorldTransformationInverse;
+		mutable Matrix4 WorldRotation;
+		mutable Matrix4 WorldNormalTransformation;
 
-		bool HasChanged();
-		void Recompute(bool doUpdate = false);
+		void MarkChanged();
+		void Recompute() const;
 
 		bool IsStaticTransformation = true;
 		bool InheritTransformation = true;
 		bool Moved = false;
-		bool HadParent = false;
-		Matrix4 OldParentTransform;
+		mutable bool WorldStale = true;
+		mutable bool InverseStale = true;
+		mutable bool RotationStale = true;
+		mutable bool NormalStale = true;
 	};
 }
@@ -0,0 +1,47 @@
+#include "TransformHierarchy.h"
+
+namespace Engine
+{
+	size_t TransformHierarchy::Add(size_t parent, const Matrix4& transformation)
+	{
+		size_t entry = Parents.size();
+
+		if (parent != NoParent && parent >= entry)
+			throw "transform hierarchy parent has to be added before its children";
+
+		Parents.push_back(parent);
+		Transformations.push_back(transformation);
+		WorldTransformations.push_back(transformation);
+
+		return entry;
+	}
+
+	void TransformHierarchy::Reserve(size_t count)
+	{
+		Parents.reserve(count);
+		Transformations.reserve(count);
+		WorldTransformations.reserve(count);
+	}
+
+	void TransformHierarchy::Clear()
+	{
+		Parents.clear();
+		Transformations.clear();
+		WorldTransformations.clear();
+	}
+
+	size_t TransformHierarchy::GetMemoryUsage() const
+	{
+		return Parents.capacity() * sizeof(size_t) + (Transformations.capacity() + WorldTransformations.capacity()) * sizeof(Matrix4);
+	}
+
+	void TransformHierarchy::Update(const Matrix4& root)
+	{
+		for (size_t i = 0; i < Parents.size(); ++i)
+		{
+			const Matrix4& parent = Parents[i] == NoParent ? root : WorldTransformations[Parents[i]];
+
+			WorldTransformations[i] = parent * Transformations[i];
+		}
+	}
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+import <vector>;
+
+#include <Engine/Math/Matrix4.h>
+
+namespace Engine
+{
+	// a whole tree of transforms as parallel arrays. parents always come before their children, so world transforms are built front to back in a single pass
+	class TransformHierarchy
+	{
+	public:
+		static const size_t NoParent = (size_t)-1;
+
+		std::vector<size_t> Parents;
+		std::vector<Matrix4> Transformations;
+		std::vector<Matrix4> WorldTransformations;
+
+		size_t Add(size_t parent, const Matrix4& transformation);
+		void Reserve(size_t count);
+		void Clear();
+		size_t GetCount() const { return Parents.size(); }
+		size_t GetMemoryUsage() const;
+
+		void Update(const Matrix4& root = Matrix4());
+	};
+}
@@ -2,6 +2,9 @@
 
 import <forward_list>;
 import <string>;
+import <mutex>;
+import <atomic>;
+import <cstdint>;
 
 // Here be dragons! Abandon all hope ye who enter here!
 // this is all mostly book keeping shit
@@ -23,10 +26,14 @@ template<int blockSize = 128, int pageSize = 4096>
 class PageAllocator : public BaseAllocator
 {
 public:
+	bool ThreadCaching = true;
+
 	void* Allocate();
 	void Free(void* data);
 
 private:
+	static const int MagazineSize = 64;
+
 
 	struct Page;
 
@@ -45,11 +52,31 @@ private:
 	{
 		Page* Owner = nullptr;
 
-		char Memory[blockSize > sizeof(nullptr) ? blockSize : sizeof(nullptr)] = {};
+		char Memory[blockSize > 2 * sizeof(nullptr) ? blockSize : 2 * sizeof(nullptr)] = {};
 	};
 
 	static const int BlocksPerPage = pageSize / sizeof(Block);
 
+	// blocks sitting in a thread's cache or in the return stack are still taken as far as their pages know, they get chained through their own memory
+	struct CachedBlock
+	{
+		CachedBlock* Next = nullptr;
+		CachedBlock* NextBatch = nullptr;
+	};
+
+	// the return stack's head carries a count in the pointer's unused high bits that changes on every swap, so a batch popped and pushed back in between can't be mistaken for the same head
+	static const int TagShift = sizeof(void*) == 4 ? 32 : 48;
+
+	// every thread keeps a magazine of free blocks for the first allocator of this type it uses, so most allocations and frees don't touch anything shared
+	struct ThreadCache
+	{
+		PageAllocator* Owner = nullptr;
+		CachedBlock* First = nullptr;
+		int Count = 0;
+
+		~ThreadCache();
+	};
+
 	struct Page
 	{
 		Block Blocks[BlocksPerPage];
@@ -83,13 +110,179 @@ private:
 	int FullPageCount = 0;
 	int OpenBlocks = BlocksPerPage;
 	int UsedBlocks = 0;
+
+	std::mutex AllocatorMutex;
+	std::atomic<unsigned long long> ReturnedBatches = 0;
+
+	static thread_local ThreadCache LocalCache;
+
+	ThreadCache* GetCache();
+	void Refill(ThreadCache& cache);
+	void Flush(ThreadCache& cache, int count);
+	CachedBlock* PopBatch();
+	void* AllocateShared();
+	void FreeShared(Block* block);
 };
 
+template<int blockSize, int pageSize>
+thread_local typename PageAllocator<blockSize, pageSize>::ThreadCache PageAllocator<blockSize, pageSize>::LocalCache;
+
 template <typename T, int pageSize = 4096>
 using ClassAllocator = PageAllocator<sizeof(T), pageSize>;
 
 template<int blockSize, int pageSize>
 void* PageAllocator<blockSize, pageSize>::Allocate()
+{
+	ThreadCache* cache = GetCache();
+
+	if (cache == nullptr)
+	{
+		std::lock_guard<std::mutex> lock(AllocatorMutex);
+
+		return AllocateShared();
+	}
+
+	if (cache->First == nullptr)
+		Refill(*cache);
+
+	CachedBlock* block = cache->First;
+
+	cache->First = block->Next;
+	--cache->Count;
+
+	return block;
+}
+
+template<int blockSize, int pageSize>
+void PageAllocator<blockSize, pageSize>::Free(void* data)
+{
+	Block* block = reinterpret_cast<Block*>(reinterpret_cast<char*>(data) - sizeof(Block*));
+
+	if (block->Owner->Owner != this)
+		throw std::string("bad block free!"); // you pressed the bad free button. you shouldn't have done that
+
+	ThreadCache* cache = GetCache();
+
+	if (cache == nullptr)
+	{
+		std::lock_guard<std::mutex> lock(AllocatorMutex);
+
+		FreeShared(block);
+
+		return;
+	}
+
+	// frees land in whichever thread let go of the block, a magazine that overflows gets handed back through the return stack
+	CachedBlock* cached = reinterpret_cast<CachedBlock*>(data);
+
+	cached->Next = cache->First;
+	cache->First = cached;
+	++cache->Count;
+
+	if (cache->Count > 2 * MagazineSize)
+		Flush(*cache, MagazineSize);
+}
+
+template<int blockSize, int pageSize>
+typename PageAllocator<blockSize, pageSize>::ThreadCache* PageAllocator<blockSize, pageSize>::GetCache()
+{
+	if (!ThreadCaching)
+		return nullptr;
+
+	ThreadCache& cache = LocalCache;
+
+	if (cache.Owner == nullptr)
+		cache.Owner = this;
+
+	return cache.Owner == this ? &cache : nullptr;
+}
+
+template<int blockSize, int pageSize>
+void PageAllocator<blockSize, pageSize>::Refill(ThreadCache& cache)
+{
+	CachedBlock* returned = PopBatch();
+
+	if (returned != nullptr)
+	{
+		cache.First = returned;
+
+		for (; returned != nullptr; returned = returned->Next)
+			++cache.Count;
+
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(AllocatorMutex);
+
+	for (int i = 0; i < MagazineSize; ++i)
+	{
+		CachedBlock* block = reinterpret_cast<CachedBlock*>(AllocateShared());
+
+		block->Next = cache.First;
+		cache.First = block;
+		++cache.Count;
+	}
+}
+
+template<int blockSize, int pageSize>
+void PageAllocator<blockSize, pageSize>::Flush(ThreadCache& cache, int count)
+{
+	if (count <= 0 || cache.First == nullptr)
+		return;
+
+	CachedBlock* first = cache.First;
+	CachedBlock* last = first;
+
+	for (int i = 1; i < count && last->Next != nullptr; ++i)
+		last = last->Next;
+
+	cache.First = last->Next;
+	cache.Count = cache.First == nullptr ? 0 : cache.Count - count;
+	last->Next = nullptr;
+
+	unsigned long long head = ReturnedBatches.load(std::memory_order_relaxed);
+	unsigned long long newHead = 0;
+
+	do
+	{
+		std::atomic_ref<CachedBlock*>(first->NextBatch).store(reinterpret_cast<CachedBlock*>(head & ((1ull << TagShift) - 1)), std::memory_order_relaxed);
+
+		newHead = ((head >> TagShift) + 1) << TagShift | reinterpret_cast<std::uintptr_t>(first);
+	}
+	while (!ReturnedBatches.compare_exchange_weak(head, newHead, std::memory_order_release, std::memory_order_relaxed));
+}
+
+template<int blockSize, int pageSize>
+typename PageAllocator<blockSize, pageSize>::CachedBlock* PageAllocator<blockSize, pageSize>::PopBatch()
+{
+	unsigned long long head = ReturnedBatches.load(std::memory_order_acquire);
+
+	while (true)
+	{
+		CachedBlock* batch = reinterpret_cast<CachedBlock*>(head & ((1ull << TagShift) - 1));
+
+		if (batch == nullptr)
+			return nullptr;
+
+		// pages are never handed back to the system, so the batch can still be read here even if another thread took it in the meantime. the swap just fails in that case
+		CachedBlock* next = std::atomic_ref<CachedBlock*>(batch->NextBatch).load(std::memory_order_relaxed);
+		unsigned long long newHead = ((head >> TagShift) + 1) << TagShift | reinterpret_cast<std::uintptr_t>(next);
+
+		if (ReturnedBatches.compare_exchange_weak(head, newHead, std::memory_order_acquire, std::memory_order_acquire))
+			return batch;
+	}
+}
+
+template<int blockSize, int pageSize>
+PageAllocator<blockSize, pageSize>::ThreadCache::~ThreadCache()
+{
+	// blocks a finished thread was holding onto go back for the others to use
+	if (Owner != nullptr)
+		Owner->Flush(*this, Count);
+}
+
+template<int blockSize, int pageSize>
+void* PageAllocator<blockSize, pageSize>::AllocateShared()
 {
 	Block* newBlock = OpenPages->Fetch();
 
@@ -125,13 +318,8 @@ void* PageAllocator<blockSize, pageSize>::Allocate()
 }
 
 template<int blockSize, int pageSize>
-void PageAllocator<blockSize, pageSize>::Free(void* data)
+void PageAllocator<blockSize, pageSize>::FreeShared(Block* block)
 {
-	Block* block = reinterpret_cast<Block*>(reinterpret_cast<char*>(data) - sizeof(Block*));
-
-	if (block->Owner->Owner != this)
-		throw std::string("bad block free!"); // you pressed the bad free button. you shouldn't have done that
-
 	Page* page = block->Owner;
 
 	page->Release(block);
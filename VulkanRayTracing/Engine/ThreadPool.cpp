@@ -0,0 +1,205 @@
+#include "ThreadPool.h"
+
+import <algorithm>;
+
+namespace Engine
+{
+	ThreadPool::ThreadPool(size_t threads)
+	{
+		if (threads == 0)
+			threads = 1;
+
+		Queues.resize(threads);
+
+		for (size_t i = 0; i < threads; ++i)
+			Queues[i] = std::make_unique<WorkerQueue>();
+
+		Workers.reserve(threads);
+
+		for (size_t i = 0; i < threads; ++i)
+			Workers.push_back(std::thread(&ThreadPool::Run, this, i));
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(SignalMutex);
+
+			Stopping = true;
+		}
+
+		WorkAvailable.notify_all();
+
+		for (size_t i = 0; i < Workers.size(); ++i)
+			Workers[i].join();
+	}
+
+	void ThreadPool::Queue(const Task& task)
+	{
+		// tasks queued from inside a worker stay on that worker's queue; everything else is dealt out round robin
+		size_t queue = CurrentPool == this ? CurrentWorker : NextQueue++ % Queues.size();
+
+		++PendingTasks;
+
+		{
+			std::lock_guard<std::mutex> lock(Queues[queue]->Mutex);
+
+			Queues[queue]->Tasks.push_back(task);
+		}
+
+		// only counted once it can actually be popped, so a woken worker always finds something unless another one beat it there
+		{
+			std::lock_guard<std::mutex> lock(SignalMutex);
+
+			++QueuedTasks;
+		}
+
+		WorkAvailable.notify_one();
+	}
+
+	void ThreadPool::Wait()
+	{
+		std::unique_lock<std::mutex> lock(SignalMutex);
+
+		WorkFinished.wait(lock, [this] { return PendingTasks == 0; });
+	}
+
+	void ThreadPool::ParallelFor(size_t count, const std::function<void(size_t)>& task)
+	{
+		struct Batch
+		{
+			std::atomic<size_t> Next = 0;
+			std::atomic<size_t> Finished = 0;
+			std::mutex ErrorMutex;
+			std::exception_ptr Error;
+			std::mutex DoneMutex;
+			std::condition_variable Done;
+		};
+
+		if (count == 0)
+			return;
+
+		std::shared_ptr<Batch> batch = std::make_shared<Batch>();
+
+		auto work = [batch, &task, count]()
+		{
+			for (size_t i = batch->Next++; i < count; i = batch->Next++)
+			{
+				try
+				{
+					task(i);
+				}
+				catch (...)
+				{
+					std::lock_guard<std::mutex> lock(batch->ErrorMutex);
+
+					if (batch->Error == nullptr)
+						batch->Error = std::current_exception();
+				}
+
+				if (++batch->Finished == count)
+				{
+					std::lock_guard<std::mutex> lock(batch->DoneMutex);
+
+					batch->Done.notify_all();
+				}
+			}
+		};
+
+		// the calling thread pitches in too, which also keeps nested batches from deadlocking a worker
+		for (size_t i = 1; i < std::min(count, Workers.size() + 1); ++i)
+			Queue(work);
+
+		work();
+
+		// every index has been claimed by now, so the thread finishing the last one is already running and this can sleep until it's done
+		{
+			std::unique_lock<std::mutex> lock(batch->DoneMutex);
+
+			batch->Done.wait(lock, [&batch, count] { return batch->Finished == count; });
+		}
+
+		if (batch->Error != nullptr)
+			std::rethrow_exception(batch->Error);
+	}
+
+	ThreadPool& ThreadPool::GetShared()
+	{
+		static ThreadPool pool;
+
+		return pool;
+	}
+
+	void ThreadPool::Run(size_t worker)
+	{
+		CurrentPool = this;
+		CurrentWorker = worker;
+
+		Task task;
+
+		while (true)
+		{
+			{
+				std::unique_lock<std::mutex> lock(SignalMutex);
+
+				WorkAvailable.wait(lock, [this] { return Stopping || QueuedTasks > 0; });
+
+				if (Stopping && QueuedTasks == 0)
+					return;
+			}
+
+			if (!Pop(worker, task) && !Steal(worker, task))
+				continue;
+
+			task();
+			task = nullptr;
+
+			if (--PendingTasks == 0)
+			{
+				std::lock_guard<std::mutex> lock(SignalMutex);
+
+				WorkFinished.notify_all();
+			}
+		}
+	}
+
+	bool ThreadPool::Pop(size_t worker, Task& task)
+	{
+		WorkerQueue& queue = *Queues[worker];
+
+		std::lock_guard<std::mutex> lock(queue.Mutex);
+
+		if (queue.Tasks.size() == 0)
+			return false;
+
+		task = std::move(queue.Tasks.back());
+		queue.Tasks.pop_back();
+
+		--QueuedTasks;
+
+		return true;
+	}
+
+	bool ThreadPool::Steal(size_t worker, Task& task)
+	{
+		// take the oldest task off of someone else's queue so the owner keeps working on what it queued most recently
+		for (size_t i = 1; i < Queues.size(); ++i)
+		{
+			WorkerQueue& queue = *Queues[(worker + i) % Queues.size()];
+
+			std::lock_guard<std::mutex> lock(queue.Mutex);
+
+			if (queue.Tasks.size() == 0)
+				continue;
+
+			task = std::move(queue.Tasks.front());
+			queue.Tasks.pop_front();
+
+			--QueuedTasks;
+
+			return true;
+		}
+
+		return false;
+	}
+}
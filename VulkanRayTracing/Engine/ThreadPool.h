@@ -0,0 +1,56 @@
+#pragma once
+
+import <vector>;
+import <deque>;
+import <memory>;
+import <functional>;
+import <thread>;
+import <mutex>;
+import <condition_variable>;
+import <atomic>;
+import <exception>;
+
+namespace Engine
+{
+	class ThreadPool
+	{
+	public:
+		typedef std::function<void()> Task;
+
+		ThreadPool(size_t threads = std::thread::hardware_concurrency());
+		~ThreadPool();
+
+		void Queue(const Task& task);
+		void Wait();
+		void ParallelFor(size_t count, const std::function<void(size_t)>& task);
+		size_t GetThreadCount() const { return Workers.size(); }
+
+		static ThreadPool& GetShared();
+
+	private:
+		struct WorkerQueue
+		{
+			std::mutex Mutex;
+			std::deque<Task> Tasks;
+		};
+
+		std::vector<std::thread> Workers;
+		std::vector<std::unique_ptr<WorkerQueue>> Queues;
+
+		std::mutex SignalMutex;
+		std::condition_variable WorkAvailable;
+		std::condition_variable WorkFinished;
+
+		std::atomic<size_t> QueuedTasks = 0;
+		std::atomic<size_t> PendingTasks = 0;
+		std::atomic<size_t> NextQueue = 0;
+		bool Stopping = false;
+
+		static inline thread_local ThreadPool* CurrentPool = nullptr;
+		static inline thread_local size_t CurrentWorker = 0;
+
+		void Run(size_t worker);
+		bool Pop(size_t worker, Task& task);
+		bool Steal(size_t worker, Task& task);
+	};
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+import <cstddef>;
+
+struct FbxCompressionEnum
+{
+	enum FbxCompression
+	{
+		None,
+		Fast,
+		Default,
+		Best
+	};
+};
+
+typedef FbxCompressionEnum::FbxCompression FbxCompression;
+
+struct FbxExportSettings
+{
+	FbxCompression Compression = FbxCompression::Default;
+	size_t CompressionThreshold = 1024; // arrays smaller than this many bytes are stored raw
+};
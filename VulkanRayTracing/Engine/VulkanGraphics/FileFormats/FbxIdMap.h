@@ -0,0 +1,108 @@
+#pragma once
+
+import <vector>;
+
+// open addressed map from fbx object ids, sized up front from the node counts so lookups while linking never rehash
+template <typename Value>
+class FbxIdMap
+{
+public:
+	void Reserve(size_t count)
+	{
+		size_t slotCount = 16;
+
+		while (slotCount < 2 * count)
+			slotCount *= 2;
+
+		if (slotCount > Slots.size())
+			Rehash(slotCount);
+	}
+
+	Value& operator[](long long id)
+	{
+		if (2 * (Count + 1) > Slots.size())
+			Rehash(Slots.size() > 0 ? 2 * Slots.size() : 16);
+
+		Slot& slot = Slots[FindSlot(id)];
+
+		if (!slot.Used)
+		{
+			slot.Used = true;
+			slot.Id = id;
+			slot.Mapped = Value();
+
+			++Count;
+		}
+
+		return slot.Mapped;
+	}
+
+	Value* Find(long long id)
+	{
+		if (Count == 0)
+			return nullptr;
+
+		Slot& slot = Slots[FindSlot(id)];
+
+		return slot.Used ? &slot.Mapped : nullptr;
+	}
+
+	const Value* Find(long long id) const
+	{
+		return const_cast<FbxIdMap*>(this)->Find(id);
+	}
+
+	size_t GetCount() const { return Count; }
+
+	void Clear()
+	{
+		Slots.clear();
+		Count = 0;
+	}
+
+private:
+	struct Slot
+	{
+		long long Id = 0;
+		Value Mapped = {};
+		bool Used = false;
+	};
+
+	std::vector<Slot> Slots;
+	size_t Count = 0;
+
+	static size_t Hash(long long id)
+	{
+		// ids are often sequential or share their high bits, so they get mixed before being masked
+		unsigned long long hash = (unsigned long long)id;
+
+		hash ^= hash >> 33;
+		hash *= 0xFF51AFD7ED558CCDull;
+		hash ^= hash >> 33;
+		hash *= 0xC4CEB9FE1A85EC53ull;
+		hash ^= hash >> 33;
+
+		return (size_t)hash;
+	}
+
+	size_t FindSlot(long long id) const
+	{
+		size_t mask = Slots.size() - 1;
+
+		for (size_t i = Hash(id) & mask; true; i = (i + 1) & mask)
+			if (!Slots[i].Used || Slots[i].Id == id)
+				return i;
+	}
+
+	void Rehash(size_t slotCount)
+	{
+		std::vector<Slot> oldSlots;
+
+		oldSlots.swap(Slots);
+		Slots.resize(slotCount);
+
+		for (size_t i = 0; i < oldSlots.size(); ++i)
+			if (oldSlots[i].Used)
+				Slots[FindSlot(oldSlots[i].Id)] = std::move(oldSlots[i]);
+	}
+};
@@ -3,62 +3,151 @@
 #include <zlib.h>
 import <sstream>;
 import <iomanip>;
+import <algorithm>;
+import <cstring>;
 
 #include <Engine/VulkanGraphics/Scene/MeshData.h>
 #include <Engine/Objects/Transform.h>
 #include <Engine/Math/Vector2S.h>
 #include <Engine/Math/Vector3S.h>
+#include <Engine/ThreadPool.h>
 
-void NodeProperty::PushData(std::istream& stream, int length)
+void PropertyBuffer::resize(size_t length)
 {
-	if (!Encoding)
+	if (View != nullptr)
 	{
-		Data.resize(length);
-		stream.read(Data.data(), length);
+		Storage.assign(View, View + std::min(length, ViewLength));
+
+		View = nullptr;
+		ViewLength = 0;
 	}
-	else
-	{
-		unsigned int entryLength = 4;
 
-		if (TypeCode == 'd' || TypeCode == 'l')
-			entryLength = 8;
-		else if (TypeCode == 'b')
-			entryLength = 1;
+	Storage.resize(length);
+}
 
-		CompressedData.resize(length);
-		stream.read(CompressedData.data(), length);
+void PropertyBuffer::clear()
+{
+	View = nullptr;
+	ViewLength = 0;
+	Storage.clear();
+}
 
-		Data.resize((size_t)((float)(ArrayLength * entryLength) * 1.1f) + 16);
+void PropertyBuffer::shrink_to_fit()
+{
+	Storage.shrink_to_fit();
+}
 
-		uLongf sizeUncompressed = (uLongf)Data.size();
-		int result = uncompress(reinterpret_cast<Bytef*>(Data.data()), &sizeUncompressed, reinterpret_cast<Bytef*>(CompressedData.data()), (uLong)CompressedData.size());
+void PropertyBuffer::Reference(const char* data, size_t length)
+{
+	Storage.clear();
+	Storage.shrink_to_fit();
 
-		switch (result)
-		{
-		case Z_OK:
+	View = data;
+	ViewLength = length;
+}
 
-			break;
-		case Z_MEM_ERROR:
-			throw "unhandled zlib memory error";
+FbxNodeStream::FbxNodeStream(std::ostream& out, size_t chunkSize) : Out(&out), Base(out.tellp()), ChunkSize(chunkSize)
+{
+	Buffer.reserve(ChunkSize);
+}
 
-			break;
-		case Z_BUF_ERROR:
-			throw "unhandled zlib buffer error";
+void FbxNodeStream::Write(const char* data, size_t size)
+{
+	if (Out != nullptr && Buffer.size() + size > ChunkSize)
+	{
+		Flush();
 
-			break;
+		// big arrays go straight through instead of being copied into the buffer first
+		if (size >= ChunkSize)
+		{
+			Out->write(data, size);
+			Flushed += size;
 
-		default:
-			throw "unhandled zlib error";
+			return;
 		}
 	}
+
+	Buffer.insert(Buffer.end(), data, data + size);
+}
+
+void FbxNodeStream::Patch(size_t position, const char* data, size_t size)
+{
+	size_t flushedSize = position < Flushed ? std::min(size, Flushed - position) : 0;
+
+	if (flushedSize > 0)
+	{
+		if (Base < 0)
+			throw "fbx output stream isn't seekable";
+
+		Out->seekp(Base + (std::streamoff)position);
+		Out->write(data, flushedSize);
+		Out->seekp(Base + (std::streamoff)Flushed);
+
+		if (!*Out)
+			throw "failed to patch fbx output stream";
+	}
+
+	if (flushedSize < size)
+		std::memcpy(Buffer.data() + (position + flushedSize - Flushed), data + flushedSize, size - flushedSize);
+}
+
+void FbxNodeStream::Flush()
+{
+	if (Out == nullptr || Buffer.size() == 0)
+		return;
+
+	Out->write(Buffer.data(), Buffer.size());
+	Flushed += Buffer.size();
+	Buffer.clear();
+}
+
+void NodeProperty::PushData(const char* data, size_t length)
+{
+	// compressed arrays are only recorded here, FbxFileStructure::InflateArrays unpacks them all once the tree has been read
+	if (!Encoding)
+		Data.Reference(data, length);
+	else
+		CompressedData.Reference(data, length);
+}
+
+void NodeProperty::Inflate()
+{
+	size_t expectedSize = GetEntryLength() * ArrayLength;
+
+	Data.resize(expectedSize);
+
+	uLongf sizeUncompressed = (uLongf)Data.size();
+	int result = uncompress(reinterpret_cast<Bytef*>(Data.data()), &sizeUncompressed, reinterpret_cast<const Bytef*>(CompressedData.data()), (uLong)CompressedData.size());
+
+	switch (result)
+	{
+	case Z_OK:
+
+		break;
+	case Z_MEM_ERROR:
+		throw "unhandled zlib memory error";
+
+		break;
+	case Z_BUF_ERROR:
+		throw "unhandled zlib buffer error";
+
+		break;
+
+	default:
+		throw "unhandled zlib error";
+	}
+
+	if ((size_t)sizeUncompressed != expectedSize)
+		throw "fbx array inflated to an unexpected size";
 }
 
-void NodeProperty::Compress()
+void NodeProperty::Compress(int level)
 {
-	CompressedData.resize((size_t)((float)Data.size() * 1.1f) + 12);
+	uLongf sizeCompressed = compressBound((uLong)Data.size());
 
-	uLongf sizeCompressed = (uLongf)CompressedData.size();
-	int result = compress(reinterpret_cast<Bytef*>(CompressedData.data()), &sizeCompressed, reinterpret_cast<Bytef*>(Data.data()), (uLong)Data.size());
+	CompressedData.resize((size_t)sizeCompressed);
+
+	int result = compress2(reinterpret_cast<Bytef*>(CompressedData.data()), &sizeCompressed, reinterpret_cast<const Bytef*>(Data.data()), (uLong)Data.size(), level);
 
 	switch (result)
 	{
@@ -78,6 +167,18 @@ void NodeProperty::Compress()
 		throw "unhandled zlib error";
 	}
 
+	// not worth the inflate on the other end if it didn't get any smaller
+	if ((size_t)sizeCompressed >= Data.size())
+	{
+		CompressedData.clear();
+		CompressedData.shrink_to_fit();
+
+		return;
+	}
+
+	CompressedData.resize((size_t)sizeCompressed);
+	CompressedData.shrink_to_fit();
+
 	Encoding = 1;
 	CompressedLength = (unsigned int)sizeCompressed;
 }
@@ -92,6 +193,16 @@ void NodeProperty::InsertData(const char* data, size_t length, size_t arrayLengt
 	ArrayLength = (unsigned int)arrayLength;
 }
 
+size_t NodeProperty::GetEntryLength() const
+{
+	if (TypeCode == 'd' || TypeCode == 'l')
+		return 8;
+	else if (TypeCode == 'b')
+		return 1;
+
+	return 4;
+}
+
 size_t NodeProperty::GetSize() const
 {
 	size_t size = sizeof(char);
@@ -134,22 +245,22 @@ size_t NodeProperty::GetSize() const
 	return size;
 }
 
-void NodeProperty::Write(std::ostream& out)
+void NodeProperty::Write(FbxNodeStream& out)
 {
-	out.write(&TypeCode, 1);
+	out.Write(&TypeCode, 1);
 
 	if (TypeCode == 'Y')
-		out.write(Data.data(), sizeof(short));
+		out.Write(Data.data(), sizeof(short));
 	else if (TypeCode == 'C')
-		out.write(Data.data(), sizeof(unsigned char));
+		out.Write(Data.data(), sizeof(unsigned char));
 	else if (TypeCode == 'I')
-		out.write(Data.data(), sizeof(int));
+		out.Write(Data.data(), sizeof(int));
 	else if (TypeCode == 'F')
-		out.write(Data.data(), sizeof(float));
+		out.Write(Data.data(), sizeof(float));
 	else if (TypeCode == 'D')
-		out.write(Data.data(), sizeof(double));
+		out.Write(Data.data(), sizeof(double));
 	else if (TypeCode == 'L')
-		out.write(Data.data(), sizeof(long long));
+		out.Write(Data.data(), sizeof(long long));
 	else if (TypeCode == 'f' || TypeCode == 'd' || TypeCode == 'l' || TypeCode == 'i' || TypeCode == 'b')
 	{
 		size_t entryLength = 4;
@@ -162,35 +273,35 @@ void NodeProperty::Write(std::ostream& out)
 		if (CompressedLength == 0)
 			CompressedLength = ArrayLength * (unsigned int)entryLength;
 
-		out.write(reinterpret_cast<char*>(&ArrayLength), sizeof(ArrayLength));
-		out.write(reinterpret_cast<char*>(&Encoding), sizeof(Encoding));
-		out.write(reinterpret_cast<char*>(&CompressedLength), sizeof(CompressedLength));
+		out.Write(reinterpret_cast<char*>(&ArrayLength), sizeof(ArrayLength));
+		out.Write(reinterpret_cast<char*>(&Encoding), sizeof(Encoding));
+		out.Write(reinterpret_cast<char*>(&CompressedLength), sizeof(CompressedLength));
 
 		if (Encoding)
-			out.write(CompressedData.data(), CompressedLength);
+			out.Write(CompressedData.data(), CompressedLength);
 		else
 		{
 
-			out.write(Data.data(), entryLength * ArrayLength);
+			out.Write(Data.data(), entryLength * ArrayLength);
 		}
 	}
 	else if (TypeCode == 'S' || TypeCode == 'R')
 	{
 		unsigned int length = (unsigned int)Data.size();
 
-		out.write(reinterpret_cast<char*>(&length), sizeof(length));
-		out.write(Data.data(), Data.size());
+		out.Write(reinterpret_cast<char*>(&length), sizeof(length));
+		out.Write(Data.data(), Data.size());
 	}
 }
 
-bool NodeProperty::operator==(const std::string& text) const
+bool NodeProperty::operator==(std::string_view text) const
 {
 	if (TypeCode != 'S') return false;
 
-	return text.compare(0, text.size(), Data.data(), ArrayLength) == 0;
+	return text == std::string_view(Data.data(), ArrayLength);
 }
 
-bool NodeProperty::operator!=(const std::string& text) const
+bool NodeProperty::operator!=(std::string_view text) const
 {
 	return !(*this == text);
 }
@@ -276,46 +387,42 @@ std::ostream& operator<<(std::ostream& out, const NodeProperty& property)
 	return out;
 }
 
-void FbxNodeHeader::Read(std::istream& stream, unsigned int version, char* buffer)
+void FbxNodeHeader::Read(BinaryReader& reader, unsigned int version)
 {
 	if (version >= 7500)
 	{
-		EndOffset = fbxEndian.read<unsigned long long>(stream);
-		NumProperties = fbxEndian.read<unsigned long long>(stream);
-		PropertySize = fbxEndian.read<unsigned long long>(stream);
+		EndOffset = reader.read<unsigned long long>();
+		NumProperties = reader.read<unsigned long long>();
+		PropertySize = reader.read<unsigned long long>();
 	}
 	else
 	{
-		EndOffset = fbxEndian.read<unsigned int>(stream);
-		NumProperties = fbxEndian.read<unsigned int>(stream);
-		PropertySize = fbxEndian.read<unsigned int>(stream);
+		EndOffset = reader.read<unsigned int>();
+		NumProperties = reader.read<unsigned int>();
+		PropertySize = reader.read<unsigned int>();
 	}
 
-	unsigned char nodeNameLength = fbxEndian.read<unsigned char>(stream);
+	unsigned char nodeNameLength = reader.read<unsigned char>();
 
 	if (nodeNameLength > 0)
-	{
-		stream.read(buffer, nodeNameLength);
-
-		Name.append(buffer, nodeNameLength);
-	}
+		Name = std::string_view(reader.readSpan(nodeNameLength), nodeNameLength);
 
 	Properties.resize(NumProperties);
 
 	for (unsigned long long i = 0; i < NumProperties; ++i)
 	{
-		char typeCode = fbxEndian.read<char>(stream);
+		char typeCode = reader.read<char>();
 
 		Properties[i].TypeCode = typeCode;
 
 		if (typeCode == 'Y')
-			Properties[i].PushData(stream, 2);
+			Properties[i].PushData(reader.readSpan(2), 2);
 		else if (typeCode == 'C')
-			Properties[i].PushData(stream, 1);
+			Properties[i].PushData(reader.readSpan(1), 1);
 		else if (typeCode == 'I' || typeCode == 'F')
-			Properties[i].PushData(stream, 4);
+			Properties[i].PushData(reader.readSpan(4), 4);
 		else if (typeCode == 'D' || typeCode == 'L')
-			Properties[i].PushData(stream, 8);
+			Properties[i].PushData(reader.readSpan(8), 8);
 		else if (typeCode == 'f' || typeCode == 'd' || typeCode == 'l' || typeCode == 'i' || typeCode == 'b')
 		{
 			unsigned int entryLength = 4;
@@ -325,19 +432,18 @@ void FbxNodeHeader::Read(std::istream& stream, unsigned int version, char* buffe
 			else if (typeCode == 'b')
 				entryLength = 1;
 
-			Properties[i].ArrayLength = fbxEndian.read<unsigned int>(stream);
-			Properties[i].Encoding = fbxEndian.read<unsigned int>(stream);
-			Properties[i].CompressedLength = fbxEndian.read<unsigned int>(stream);
+			Properties[i].ArrayLength = reader.read<unsigned int>();
+			Properties[i].Encoding = reader.read<unsigned int>();
+			Properties[i].CompressedLength = reader.read<unsigned int>();
 
-			if (Properties[i].Encoding == 0)
-				Properties[i].PushData(stream, entryLength * Properties[i].ArrayLength);
-			else
-				Properties[i].PushData(stream, Properties[i].CompressedLength);
+			size_t length = Properties[i].Encoding == 0 ? (size_t)entryLength * Properties[i].ArrayLength : (size_t)Properties[i].CompressedLength;
+
+			Properties[i].PushData(reader.readSpan(length), length);
 		}
 		else if (typeCode == 'S' || typeCode == 'R')
 		{
-			Properties[i].ArrayLength = fbxEndian.read<unsigned int>(stream);
-			Properties[i].PushData(stream, Properties[i].ArrayLength);
+			Properties[i].ArrayLength = reader.read<unsigned int>();
+			Properties[i].PushData(reader.readSpan(Properties[i].ArrayLength), Properties[i].ArrayLength);
 		}
 	}
 }
@@ -347,8 +453,11 @@ bool FbxNodeHeader::IsNull() const
 	return EndOffset == 0 && NumProperties == 0 && PropertySize == 0 && NameLength == 0;
 }
 
-FbxNode* FbxNode::Find(const std::string& name)
+FbxNode* FbxNode::Find(std::string_view name)
 {
+	if (Lookup != nullptr)
+		return Lookup->FindChild(this, name);
+
 	for (size_t i = 0; i < Children.size(); ++i)
 		if (Children[i]->Header.Name == name)
 			return Children[i];
@@ -356,8 +465,11 @@ FbxNode* FbxNode::Find(const std::string& name)
 	return nullptr;
 };
 
-FbxNode* FbxNode::FindWith(const std::string& text, size_t index)
+FbxNode* FbxNode::FindWith(std::string_view text, size_t index)
 {
+	if (Lookup != nullptr && index == 0)
+		return Lookup->FindChildWith(this, text);
+
 	for (size_t i = 0; i < Children.size(); ++i)
 		if (Children[i]->Header.Properties.size() > index && Children[i]->Header.Properties[index] == text)
 			return Children[i];
@@ -372,6 +484,13 @@ NodeProperty* FbxNode::GetProperty(size_t index)
 	return &Header.Properties[index];
 }
 
+std::string_view FbxNode::GetStringProperty(size_t index) const
+{
+	if (Header.Properties.size() <= index || Header.Properties[index].TypeCode != 'S') return std::string_view();
+
+	return std::string_view(Header.Properties[index].Data.data(), Header.Properties[index].Data.size());
+}
+
 FbxObjectNode* FbxNode::MakeObjectNode()
 {
 	if (ObjectNode == nullptr)
@@ -382,76 +501,55 @@ FbxObjectNode* FbxNode::MakeObjectNode()
 	return ObjectNode.get();
 }
 
-void FbxNode::Write(std::ostream& out)
+void FbxNode::Write(FbxNodeStream& out, std::vector<FbxNode>& nodes)
 {
-	unsigned long long currentPos = (unsigned long long)out.tellp();
+	WriteBegin(out);
 
-	if (currentPos != Header.StartOffset)
-		throw "mismatching start offset";
+	for (size_t i = 0; i < ChildIndices.size(); ++i)
+		nodes[ChildIndices[i]].Write(out, nodes);
 
-	unsigned char nameLength = (unsigned char)Header.Name.size();
+	WriteEnd(out);
+}
 
-	out.write(reinterpret_cast<char*>(&Header.EndOffset), sizeof(Header.EndOffset));
-	out.write(reinterpret_cast<char*>(&Header.NumProperties), sizeof(Header.NumProperties));
-	out.write(reinterpret_cast<char*>(&Header.PropertySize), sizeof(Header.PropertySize));
-	out.write(reinterpret_cast<char*>(&nameLength), sizeof(nameLength));
-	out.write(Header.Name.c_str(), Header.Name.size());
+void FbxNode::WriteBegin(FbxNodeStream& out)
+{
+	size_t start = out.Tell();
 
-	for (size_t i = 0; i < Header.Properties.size(); ++i)
-		Header.Properties[i].Write(out);
+	unsigned char nameLength = (unsigned char)Header.Name.size();
 
-	for (size_t i = 0; i < Children.size(); ++i)
-		Children[i]->Write(out);
+	Header.StartOffset = (unsigned long long)start;
+	Header.NameLength = nameLength;
+	Header.NumProperties = (unsigned long long)Header.Properties.size();
+	Header.EndOffset = 0;
+	Header.PropertySize = 0;
 
-	char nullNode[3 * sizeof(Header.EndOffset) + sizeof(unsigned char)] = {0};
+	// the end offset gets patched in by WriteEnd once everything under this node has been written
+	out.Write(reinterpret_cast<char*>(&Header.EndOffset), sizeof(Header.EndOffset));
+	out.Write(reinterpret_cast<char*>(&Header.NumProperties), sizeof(Header.NumProperties));
+	out.Write(reinterpret_cast<char*>(&Header.PropertySize), sizeof(Header.PropertySize));
+	out.Write(reinterpret_cast<char*>(&nameLength), sizeof(nameLength));
+	out.Write(Header.Name.data(), Header.Name.size());
+
+	size_t propertiesStart = out.Tell();
 
-	if (Children.size() > 0 || ForceEndMarker)
-		out.write(nullNode, sizeof(nullNode));
+	for (size_t i = 0; i < Header.Properties.size(); ++i)
+		Header.Properties[i].Write(out);
 
-	currentPos = (unsigned long long)out.tellp();
+	Header.PropertySize = (unsigned long long)(out.Tell() - propertiesStart);
 
-	if (currentPos != Header.EndOffset)
-		throw "mismatching end offset";
+	out.Patch(start + 2 * sizeof(unsigned long long), reinterpret_cast<char*>(&Header.PropertySize), sizeof(Header.PropertySize));
 }
 
-void FbxNode::ComputeEnd(size_t start, std::vector<FbxNode>& nodes)
+void FbxNode::WriteEnd(FbxNodeStream& out)
 {
-	Header.StartOffset = (unsigned long long)start;
-	Header.NameLength = (unsigned char)Header.Name.size();
-
-	Children.resize(ChildIndices.size());
-
-	for (size_t i = 0; i < Children.size(); ++i)
-		Children[i] = &nodes[ChildIndices[i]];
-
-	size_t end = start;
-	end += sizeof(unsigned long long); // EndOffset
-	end += sizeof(unsigned long long); // NumProperties
-	end += sizeof(unsigned long long); // PropertySize
-	end += sizeof(unsigned char); // NameLength
-	end += (size_t)Header.NameLength;
-	
-	Header.PropertySize = 0;
-	Header.NumProperties = (unsigned long long)Header.Properties.size();
-
-	for (unsigned long long i = 0; i < Header.NumProperties; ++i)
-	{
-		size_t size = Header.Properties[i].GetSize();
-
-		Header.PropertySize += (unsigned long long)size;
-		end += size;
-	}
+	char nullNode[3 * sizeof(Header.EndOffset) + sizeof(unsigned char)] = {0};
 
-	for (size_t i = 0; i < Children.size(); ++i)
-	{
-		Children[i]->ComputeEnd(end, nodes);
-		end = Children[i]->Header.EndOffset;
-	}
+	if (ChildIndices.size() > 0 || ForceEndMarker)
+		out.Write(nullNode, sizeof(nullNode));
 
-	if (Children.size() > 0 || ForceEndMarker)
-		end += 3 * sizeof(unsigned long long) + sizeof(unsigned char);
+	Header.EndOffset = (unsigned long long)out.Tell();
 
-	Header.EndOffset = (unsigned long long)end;
+	out.Patch((size_t)Header.StartOffset, reinterpret_cast<char*>(&Header.EndOffset), sizeof(Header.EndOffset));
 }
 
 void FbxNode::ComputeChildrenEnd(std::vector<FbxNode>& nodes)
@@ -465,15 +563,21 @@ void FbxNode::ComputeChildrenEnd(std::vector<FbxNode>& nodes)
 		Children[i] = &nodes[ChildIndices[i]];
 }
 
-void FbxFileStructure::ReadNodes(std::istream& stream)
+void FbxFileStructure::ReadNodes(const char* data, size_t size)
 {
-	const size_t bufferSize = 0xFFF;
-	char buffer[bufferSize] = {};
+	const size_t headerSize = 27;
+
+	if (size < headerSize)
+		throw "fbx file too small";
 
-	stream.read(buffer, 27);
+	BinaryReader reader(data, size, fbxEndian);
 
-	unsigned int version = fbxEndian.read<unsigned int>(buffer + 23);
-	unsigned long long currentPos = (unsigned long long)stream.tellg();
+	reader.seek(23);
+
+	unsigned int version = reader.read<unsigned int>();
+	size_t currentPos = headerSize;
+
+	reader.seek(headerSize);
 
 	std::vector<size_t> nodeStack;
 
@@ -489,7 +593,7 @@ void FbxFileStructure::ReadNodes(std::istream& stream)
 			parentIndex = nodeStack.back();
 	
 		nodeStack.push_back(index);
-		Nodes.push_back(FbxNode());
+		Nodes.emplace_back(&Arena);
 	
 		FbxNode& node = Nodes.back();
 	
@@ -497,7 +601,9 @@ void FbxFileStructure::ReadNodes(std::istream& stream)
 		node.Parent = parentIndex;
 		node.Header.StartOffset = currentPos;
 		node.Depth = nodeStack.size();
-		node.Header.Read(stream, version, buffer);
+		node.Header.Read(reader, version);
+
+		currentPos = reader.tell();
 
 		if (node.Header.IsNull())
 			++nullNodes;
@@ -512,8 +618,6 @@ void FbxFileStructure::ReadNodes(std::istream& stream)
 				RootNode.ChildIndices.push_back(index);
 		}
 	
-		currentPos = (unsigned long long)stream.tellg();
-	
 		while (nodeStack.size() > 0 && currentPos >= Nodes[nodeStack.back()].Header.EndOffset)
 		{
 			if (currentPos != Nodes[nodeStack.back()].Header.EndOffset && !Nodes[nodeStack.back()].Header.IsNull())
@@ -526,15 +630,112 @@ void FbxFileStructure::ReadNodes(std::istream& stream)
 	if (DebugPrint)
 		std::cout << "null nodes: " << nullNodes << std::endl;
 
-	unsigned long long beforeHeader = (unsigned long long)stream.tellg();
+	InflateArrays();
+
+	Lookup.Build(Nodes, RootNode);
+}
+
+void FbxFileStructure::LinkObjects()
+{
+	FbxNode* objectsNode = RootNode.Find("Objects");
+	FbxNode* connectionsNode = RootNode.Find("Connections");
+
+	if (objectsNode == nullptr)
+		return;
+
+	size_t objectCount = objectsNode->ChildIndices.size();
+	size_t connectionCount = connectionsNode != nullptr ? connectionsNode->ChildIndices.size() : 0;
+
+	FbxObjectNodes.Clear();
+	FbxObjectNodes.Reserve(objectCount);
+	RootObjects.clear();
+
+	std::vector<FbxObjectNode*> objects(objectCount);
+
+	for (size_t i = 0; i < objectCount; ++i)
+	{
+		FbxNode* node = &Nodes[objectsNode->ChildIndices[i]];
+
+		objects[i] = node->MakeObjectNode();
+		objects[i]->Id = fbxEndian.read<long long>(node->Header.Properties[0].Data.data());
+		objects[i]->ObjectIndex = i;
+
+		FbxObjectNodes[objects[i]->Id] = node;
+	}
+
+	// connections are counted per object first so both directions can be laid out as flat arrays, each object's entries staying in file order
+	std::vector<std::pair<FbxObjectNode*, FbxObjectNode*>> links;
+	std::vector<size_t> referencedByOffsets(objectCount + 1, 0);
+	std::vector<size_t> referenceOffsets(objectCount + 1, 0);
+
+	links.reserve(connectionCount);
+
+	for (size_t i = 0; i < connectionCount; ++i)
+	{
+		FbxNode* connection = &Nodes[connectionsNode->ChildIndices[i]];
+
+		if (connection->Header.Properties.size() < 3)
+			continue;
+
+		long long id1 = fbxEndian.read<long long>(connection->Header.Properties[1].Data.data());
+		long long id2 = fbxEndian.read<long long>(connection->Header.Properties[2].Data.data());
+
+		FbxNode** node1 = FbxObjectNodes.Find(id1);
+		FbxNode** node2 = FbxObjectNodes.Find(id2);
+
+		if (node1 != nullptr && node2 != nullptr)
+		{
+			FbxObjectNode* object1 = (*node1)->ObjectNode.get();
+			FbxObjectNode* object2 = (*node2)->ObjectNode.get();
+
+			links.push_back(std::make_pair(object1, object2));
 
-	stream.read(buffer, bufferSize); // footer
+			++referencedByOffsets[object1->ObjectIndex + 1];
+			++referenceOffsets[object2->ObjectIndex + 1];
+		}
+		else if (node1 != nullptr && id2 == 0)
+			RootObjects.push_back(*node1);
+	}
 
-	currentPos = (unsigned long long)stream.tellg();
+	for (size_t i = 0; i < objectCount; ++i)
+	{
+		referencedByOffsets[i + 1] += referencedByOffsets[i];
+		referenceOffsets[i + 1] += referenceOffsets[i];
+	}
 
-	auto diff1 = stream.gcount();
+	ObjectReferencedBy.resize(links.size());
+	ObjectReferences.resize(links.size());
+
+	std::vector<size_t> referencedByFill(referencedByOffsets.begin(), referencedByOffsets.end() - 1);
+	std::vector<size_t> referenceFill(referenceOffsets.begin(), referenceOffsets.end() - 1);
+
+	for (size_t i = 0; i < links.size(); ++i)
+	{
+		ObjectReferencedBy[referencedByFill[links[i].first->ObjectIndex]++] = links[i].second;
+		ObjectReferences[referenceFill[links[i].second->ObjectIndex]++] = links[i].first;
+	}
 
-	unsigned long long diff = currentPos - beforeHeader;
+	for (size_t i = 0; i < objectCount; ++i)
+	{
+		objects[i]->ReferencedBy = std::span<FbxObjectNode*>(ObjectReferencedBy.data() + referencedByOffsets[i], referencedByOffsets[i + 1] - referencedByOffsets[i]);
+		objects[i]->References = std::span<FbxObjectNode*>(ObjectReferences.data() + referenceOffsets[i], referenceOffsets[i + 1] - referenceOffsets[i]);
+	}
+}
+
+void FbxFileStructure::InflateArrays()
+{
+	std::vector<NodeProperty*> compressed;
+
+	for (size_t i = 0; i < Nodes.size(); ++i)
+		for (size_t j = 0; j < Nodes[i].Header.Properties.size(); ++j)
+			if (Nodes[i].Header.Properties[j].NeedsInflating())
+				compressed.push_back(&Nodes[i].Header.Properties[j]);
+
+	// every array inflates into its own exactly sized buffer, so they can all go at once
+	if (compressed.size() > 1)
+		Engine::ThreadPool::GetShared().ParallelFor(compressed.size(), [&compressed](size_t i) { compressed[i]->Inflate(); });
+	else if (compressed.size() == 1)
+		compressed[0]->Inflate();
 }
 
 void encrypt(char* bytes, const char* key)
@@ -547,20 +748,40 @@ void encrypt(char* bytes, const char* key)
 	}
 }
 
-void FbxFileStructure::WriteNodes(std::ostream& out)
+void FbxFileStructure::StreamFile(std::ostream& out)
 {
-	char buffer[0xFF] = { 'K', 'a', 'y', 'd', 'a', 'r', 'a', ' ', 'F', 'B', 'X', ' ', 'B', 'i', 'n', 'a', 'r', 'y', ' ', ' ', 0, 0x1A, 0 };
+	FbxNodeStream stream(out);
+
+	Output = &stream;
+	SectionsWritten = 0;
+	ObjectsWritten = 0;
+
+	WriteFileHeader(stream);
+	MakeFileStructure();
+	StreamSections();
+	WriteFileFooter(stream);
+
+	stream.Flush();
+
+	Output = nullptr;
+}
+
+void FbxFileStructure::WriteFileHeader(FbxNodeStream& stream)
+{
+	char buffer[27] = { 'K', 'a', 'y', 'd', 'a', 'r', 'a', ' ', 'F', 'B', 'X', ' ', 'B', 'i', 'n', 'a', 'r', 'y', ' ', ' ', 0, 0x1A, 0 };
 
 	*reinterpret_cast<unsigned int*>(buffer + 23) = 7700; // TODO: fix endian later
 
-	out.write(buffer, 27);
+	stream.Write(buffer, 27);
+}
 
-	for (size_t i = 0; i < RootNode.ChildIndices.size(); ++i)
-		Nodes[RootNode.ChildIndices[i]].Write(out);
+void FbxFileStructure::WriteFileFooter(FbxNodeStream& stream)
+{
+	unsigned int version = 7700;
 
 	char nullNode[3 * sizeof(unsigned long long) + sizeof(unsigned char)] = { 0 };
 
-	out.write(nullNode, sizeof(nullNode));
+	stream.Write(nullNode, sizeof(nullNode));
 
 	char sourceId[] = { (char)0x58, (char)0xAB, (char)0xA9, (char)0xF0, (char)0x6C, (char)0xA2, (char)0xD8, (char)0x3F, (char)0x4D, (char)0x47, (char)0x49, (char)0xA3, (char)0xB4, (char)0xB2, (char)0xE7, (char)0x3D };
 	const char key[] = { (char)0xE2, (char)0x4F, (char)0x7B, (char)0x5F, (char)0xCD, (char)0xE4, (char)0xC8, (char)0x6D, (char)0xDB, (char)0xD8, (char)0xFB, (char)0xD7, (char)0x40, (char)0x58, (char)0xC6, (char)0x78 };
@@ -588,57 +809,54 @@ void FbxFileStructure::WriteNodes(std::ostream& out)
 	encrypt(sourceId, key);
 	encrypt(sourceId, mangled.str().c_str());
 
-	out.write(sourceId, 16);
+	stream.Write(sourceId, 16);
 
 	const size_t footerZeros1 = 20;
 	const size_t footerZeros2 = 120;
 	
 	char zeros[std::max(footerZeros1, footerZeros2)] = { 0 };
 
-	out.write(zeros, footerZeros1);
-	out.write(buffer + 23, 4);
-	out.write(zeros, footerZeros2);
+	stream.Write(zeros, footerZeros1);
+	stream.Write(reinterpret_cast<char*>(&version), sizeof(version));
+	stream.Write(zeros, footerZeros2);
 
 	char extension[] = { (char)0xF8, (char)0x5A, (char)0x8C, (char)0x6A, (char)0xDE, (char)0xF5, (char)0xD9, (char)0x7E, (char)0xEC, (char)0xE9, (char)0x0C, (char)0xE3, (char)0x75, (char)0x8F, (char)0x29, (char)0x0B };
 
-	out.write(extension, sizeof(extension));
+	stream.Write(extension, sizeof(extension));
 }
 
 using Engine::Graphics::VertexAttributeFormat;
 
 const std::shared_ptr<Engine::Graphics::MeshFormat>& GetFbxMeshFormat()
 {
-	static std::shared_ptr<Engine::Graphics::MeshFormat> format;
-
-	if (format != nullptr) return format;
-
-	std::vector<VertexAttributeFormat> attributes;
-
-	attributes.push_back(VertexAttributeFormat{ Enum::AttributeDataType::Float64, 3, "position", attributes.size() });
-	attributes.push_back(VertexAttributeFormat{ Enum::AttributeDataType::Float64, 3, "normal", attributes.size() });
-	attributes.push_back(VertexAttributeFormat{ Enum::AttributeDataType::Float64, 2, "textureCoords", attributes.size() });
-	attributes.push_back(VertexAttributeFormat{ Enum::AttributeDataType::Float64, 3, "binormal", attributes.size() });
-	attributes.push_back(VertexAttributeFormat{ Enum::AttributeDataType::Float64, 3, "tangent", attributes.size() });
+	static std::shared_ptr<Engine::Graphics::MeshFormat> format = []()
+	{
+		std::vector<VertexAttributeFormat> attributes;
 
+		attributes.push_back(VertexAttributeFormat{ Enum::AttributeDataType::Float64, 3, "position", attributes.size() });
+		attributes.push_back(VertexAttributeFormat{ Enum::AttributeDataType::Float64, 3, "normal", attributes.size() });
+		attributes.push_back(VertexAttributeFormat{ Enum::AttributeDataType::Float64, 2, "textureCoords", attributes.size() });
+		attributes.push_back(VertexAttributeFormat{ Enum::AttributeDataType::Float64, 3, "binormal", attributes.size() });
+		attributes.push_back(VertexAttributeFormat{ Enum::AttributeDataType::Float64, 3, "tangent", attributes.size() });
 
-	format = Engine::Graphics::MeshFormat::GetFormat(attributes);
+		return Engine::Graphics::MeshFormat::GetFormat(attributes);
+	}();
 
 	return format;
 }
 
 const std::shared_ptr<Engine::Graphics::MeshFormat>& GetFbxMeshKeyFormat()
 {
-	static std::shared_ptr<Engine::Graphics::MeshFormat> format;
-
-	if (format != nullptr) return format;
-
-	std::vector<VertexAttributeFormat> attributes;
+	static std::shared_ptr<Engine::Graphics::MeshFormat> format = []()
+	{
+		std::vector<VertexAttributeFormat> attributes;
 
-	attributes.push_back(VertexAttributeFormat{ Enum::AttributeDataType::Float64, 3, "position", attributes.size() });
-	attributes.push_back(VertexAttributeFormat{ Enum::AttributeDataType::Float64, 3, "normal", attributes.size() });
-	attributes.push_back(VertexAttributeFormat{ Enum::AttributeDataType::Float64, 3, "morphPosition1", attributes.size() });
+		attributes.push_back(VertexAttributeFormat{ Enum::AttributeDataType::Float64, 3, "position", attributes.size() });
+		attributes.push_back(VertexAttributeFormat{ Enum::AttributeDataType::Float64, 3, "normal", attributes.size() });
+		attributes.push_back(VertexAttributeFormat{ Enum::AttributeDataType::Float64, 3, "morphPosition1", attributes.size() });
 
-	format = Engine::Graphics::MeshFormat::GetFormat(attributes);
+		return Engine::Graphics::MeshFormat::GetFormat(attributes);
+	}();
 
 	return format;
 }
@@ -676,51 +894,106 @@ size_t FbxFileStructure::AddCategory(const std::string& name)
 	return category;
 }
 
-FbxObjectNode* FbxObjectNode::FindRef(const char* name, const char* type)
+FbxObjectNode* FbxObjectNode::FindRef(std::string_view name, const char* type)
 {
-	FbxNode* node = Parent;
-
-	for (size_t i = 0; i < node->ObjectNode->References.size(); ++i)
+	for (size_t i = 0; i < References.size(); ++i)
 	{
-		FbxObjectNode* childObject = node->ObjectNode->References[i];
-		FbxNode* childNode = childObject->Parent;
+		FbxNode* childNode = References[i]->Parent;
 
-		std::string childObjectType;
+		if (childNode->Header.Name == name && (type == nullptr || childNode->GetStringProperty(2) == type))
+			return References[i];
+	}
+
+	return nullptr;
+}
 
-		if (childNode->Header.Properties.size() >= 2 && childNode->Header.Properties[2].TypeCode == 'S')
-			childObjectType = vectorToString(childNode->Header.Properties[2].Data);
+FbxObjectNode* FbxObjectNode::FindRefBy(std::string_view name, const char* type)
+{
+	for (size_t i = 0; i < ReferencedBy.size(); ++i)
+	{
+		FbxNode* childNode = ReferencedBy[i]->Parent;
 
-		if (childNode->Header.Name == name && (type == nullptr || childObjectType == type))
-			return childObject;
+		if (childNode->Header.Name == name && (type == nullptr || childNode->GetStringProperty(2) == type))
+			return ReferencedBy[i];
 	}
 
 	return nullptr;
 }
 
-FbxObjectNode* FbxObjectNode::FindRefBy(const char* name, const char* type)
+size_t FbxNodeLookup::ChildKeyHash::operator()(const ChildKey& key) const
+{
+	return std::hash<std::string_view>()(key.Text) ^ (std::hash<const void*>()(key.Parent) * 0x9E3779B97F4A7C15ull);
+}
+
+void FbxNodeLookup::Build(std::vector<FbxNode>& nodes, FbxNode& root)
 {
-	FbxNode* node = Parent;
+	Clear();
 
-	for (size_t i = 0; i < node->ObjectNode->ReferencedBy.size(); ++i)
+	ChildrenByName.reserve(nodes.size());
+	ChildrenByTag.reserve(nodes.size());
+
+	auto indexChildren = [this, &nodes](FbxNode& parent)
 	{
-		FbxObjectNode* childObject = node->ObjectNode->ReferencedBy[i];
-		FbxNode* childNode = childObject->Parent;
+		parent.Lookup = this;
 
-		std::string childObjectType;
+		// emplace keeps the first child under a key, which is the one a linear scan would have found
+		for (size_t i = 0; i < parent.ChildIndices.size(); ++i)
+		{
+			FbxNode* child = &nodes[parent.ChildIndices[i]];
 
-		if (childNode->Header.Properties.size() >= 2 && childNode->Header.Properties[2].TypeCode == 'S')
-			childObjectType = vectorToString(childNode->Header.Properties[2].Data);
+			ChildrenByName.emplace(ChildKey{ &parent, child->Header.Name }, child);
 
-		if (childNode->Header.Name == name && (type == nullptr || childObjectType == type))
-			return childObject;
+			if (child->Header.Properties.size() > 0 && child->Header.Properties[0].TypeCode == 'S')
+				ChildrenByTag.emplace(ChildKey{ &parent, std::string_view(child->Header.Properties[0].Data.data(), child->Header.Properties[0].ArrayLength) }, child);
+		}
+	};
+
+	indexChildren(root);
+
+	for (size_t i = 0; i < nodes.size(); ++i)
+		indexChildren(nodes[i]);
+
+	FbxNode* objects = FindChild(&root, "Objects");
+
+	if (objects == nullptr)
+		return;
+
+	for (size_t i = 0; i < objects->ChildIndices.size(); ++i)
+	{
+		FbxNode* object = &nodes[objects->ChildIndices[i]];
+
+		ObjectsByClass[ObjectClass(object->Header.Name, object->GetStringProperty(2))].push_back(object);
 	}
+}
 
-	return nullptr;
+void FbxNodeLookup::Clear()
+{
+	ChildrenByName.clear();
+	ChildrenByTag.clear();
+	ObjectsByClass.clear();
+}
+
+FbxNode* FbxNodeLookup::FindChild(const FbxNode* parent, std::string_view name) const
+{
+	auto child = ChildrenByName.find(ChildKey{ parent, name });
+
+	return child != ChildrenByName.end() ? child->second : nullptr;
 }
 
-std::string vectorToString(const std::vector<char>& vector)
+FbxNode* FbxNodeLookup::FindChildWith(const FbxNode* parent, std::string_view text) const
 {
-	return std::string(vector.data(), vector.size());
+	auto child = ChildrenByTag.find(ChildKey{ parent, text });
+
+	return child != ChildrenByTag.end() ? child->second : nullptr;
+}
+
+const std::vector<FbxNode*>& FbxNodeLookup::FindObjects(std::string_view className, std::string_view subType) const
+{
+	static const std::vector<FbxNode*> noObjects;
+
+	auto objects = ObjectsByClass.find(ObjectClass(className, subType));
+
+	return objects != ObjectsByClass.end() ? objects->second : noObjects;
 }
 
 using namespace std::string_literals;
@@ -1030,7 +1303,12 @@ void FbxFileStructure::MakeFileStructure()
 		}
 	}
 
+	// everything up to the objects is final now, apart from the definition counts
+	StreamSections();
+
 	Objects = AddNode("Objects");
+
+	BeginObjects();
 	{
 		std::shared_ptr<Engine::Graphics::MeshFormat> format = GetFbxMeshFormat();
 		std::shared_ptr<Engine::Graphics::MeshData> stagingData = Engine::Create<Engine::Graphics::MeshData>();
@@ -1061,8 +1339,14 @@ void FbxFileStructure::MakeFileStructure()
 
 		std::vector<NodeData> nodes(Package->Nodes.size());
 
-		for (size_t i = 0; i < Package->Nodes.size(); ++i)
+		if (!Package->HasHierarchy())
+			Package->BuildHierarchy();
+
+		// parents have to exist before their children can connect to them
+		for (size_t order = 0; order < Package->TopologicalOrder.size(); ++order)
 		{
+			size_t i = Package->TopologicalOrder[order];
+
 			Engine::Graphics::ModelPackageNode& node = Package->Nodes[i];
 			NodeData& data = nodes[i];
 
@@ -1228,6 +1512,8 @@ void FbxFileStructure::MakeFileStructure()
 					addLayerElement("textureCoords", "LayerElementUV");
 				}
 
+				StreamObjects(data.Geometry);
+
 				data.MeshModel = AddProperties(AddObject("Model", Objects), objectId(), node.Name + "\00\01Model"s, "Mesh");
 				{
 					AddProperty(AddNode("Version", data.MeshModel), FbxVersion::Model);
@@ -1253,8 +1539,8 @@ void FbxFileStructure::MakeFileStructure()
 
 					AddProperty<unsigned char>(AddNode("Shading", data.MeshModel), 'Y');
 					AddProperty(AddNode("Culling", data.MeshModel), "CullingOff");
-					AddProperty(AddNode("MultiLayer", data.Model), 0);
-					AddProperty(AddNode("MultiTake", data.Model), 0);
+					AddProperty(AddNode("MultiLayer", data.MeshModel), 0);
+					AddProperty(AddNode("MultiTake", data.MeshModel), 0);
 				}
 
 				AddConnection("OO", (long long)data.MeshModel, 0);
@@ -1324,6 +1610,8 @@ void FbxFileStructure::MakeFileStructure()
 					AddProperty(AddNode("TransformLink", meshSubdeformer), ArrayWrapper<double>{ &identity.Data[0][0], 16 });
 				}
 
+				StreamObjects(meshSubdeformer);
+
 				AddConnection("OO", (long long)meshSubdeformer, (long long)data.Deformer);
 				AddConnection("OO", (long long)data.Model, (long long)meshSubdeformer);
 
@@ -1386,6 +1674,8 @@ void FbxFileStructure::MakeFileStructure()
 						AddProperty(AddNode("Normals", data.ShapeKey), ArrayWrapper<double>{reinterpret_cast<double*>(vertexBuffers[stagingNormal->Binding]), vertexCount * 3, true });
 					}
 
+					StreamObjects(data.ShapeKey);
+
 					size_t shapeKeyDeformer = AddProperties(AddObject("Deformer", Objects), objectId(), node.Name + std::string("\00\01Deformer"s), "BlendShape");
 					{
 						AddProperty(AddNode("Version", shapeKeyDeformer), FbxVersion::DeformerShape);
@@ -1404,6 +1694,8 @@ void FbxFileStructure::MakeFileStructure()
 						AddProperty(AddNode("FullWeights", shapeKeySubdeformer), ArrayWrapper<double>{shapeKeyStagingData.data(), vertexCount, true });
 					}
 
+					StreamObjects(shapeKeySubdeformer);
+
 					AddConnection("OO", (long long)shapeKeySubdeformer, (long long)shapeKeyDeformer);
 					AddConnection("OO", (long long)data.ShapeKey, (long long)shapeKeySubdeformer);
 					AddConnection("OO", (long long)shapeKeyDeformer, (long long)data.Geometry);
@@ -1411,6 +1703,12 @@ void FbxFileStructure::MakeFileStructure()
 			}
 		}
 
+		std::vector<std::vector<size_t>> materialNodes(Package->Materials.size());
+
+		for (size_t i = 0; i < Package->Nodes.size(); ++i)
+			if (Package->Nodes[i].MaterialIndex < materialNodes.size())
+				materialNodes[Package->Nodes[i].MaterialIndex].push_back(i);
+
 		for (size_t i = 0; i < Package->Materials.size(); ++i)
 		{
 			Engine::Graphics::ModelPackageMaterial packageMaterial = Package->Materials[i];
@@ -1432,9 +1730,8 @@ void FbxFileStructure::MakeFileStructure()
 				AddProperties(AddNode("P", properties), "Reflectivity", "double", "Number", "", 0.0);
 			}
 
-			for (size_t j = 0; j < Package->Nodes.size(); ++j)
-				if (Package->Nodes[j].MaterialIndex == i)
-					AddConnection("OO", (long long)material, nodes[j].MeshModel);
+			for (size_t j = 0; j < materialNodes[i].size(); ++j)
+				AddConnection("OO", (long long)material, nodes[materialNodes[i][j]].MeshModel);
 
 			size_t diffuseVideo = AddProperties(AddObject("Video", Objects), objectId(), std::string("Diffuse Texture\00\01Video"s), "Clip");
 			{
@@ -1547,6 +1844,9 @@ void FbxFileStructure::MakeFileStructure()
 			AddConnection("OO", (long long)specularVideo, (long long)specularTexture);
 		}
 	}
+
+	EndObjects();
+
 	Connections = AddNode("Connections");
 	{
 		for (size_t i = 0; i < ObjectConnections.size(); ++i)
@@ -1565,21 +1865,126 @@ void FbxFileStructure::MakeFileStructure()
 	}
 }
 
-void FbxFileStructure::FinalizeNodes()
+void FbxFileStructure::CompressArrays(size_t root)
 {
-	size_t end = 27;
+	if (Settings.Compression == FbxCompression::None)
+		return;
+
+	int level = Z_DEFAULT_COMPRESSION;
 
-	for (size_t i = 0; i < RootNode.ChildIndices.size(); ++i)
+	if (Settings.Compression == FbxCompression::Fast)
+		level = Z_BEST_SPEED;
+	else if (Settings.Compression == FbxCompression::Best)
+		level = Z_BEST_COMPRESSION;
+
+	std::vector<NodeProperty*> arrays;
+
+	auto gatherArrays = [this, &arrays](FbxNode& node)
+	{
+		for (size_t j = 0; j < node.Header.Properties.size(); ++j)
+		{
+			NodeProperty& property = node.Header.Properties[j];
+
+			if (property.IsArray() && property.Encoding == 0 && property.Data.size() > 0 && property.Data.size() >= Settings.CompressionThreshold)
+				arrays.push_back(&property);
+		}
+	};
+
+	std::vector<size_t> nodeStack = { root };
+
+	while (nodeStack.size() > 0)
 	{
-		Nodes[RootNode.ChildIndices[i]].ComputeEnd(end, Nodes);
+		FbxNode& node = Nodes[nodeStack.back()];
 
-		end = Nodes[RootNode.ChildIndices[i]].Header.EndOffset;
+		nodeStack.pop_back();
+		gatherArrays(node);
+		nodeStack.insert(nodeStack.end(), node.ChildIndices.begin(), node.ChildIndices.end());
 	}
-	//for (size_t i = 0; i < Nodes.size(); ++i)
-	//	Nodes[i].ComputeEnd(i == 0 ? 27 : Nodes[i - 1].Header.EndOffset);
-	//
-	//for (size_t i = Nodes.size() - 1; i < Nodes.size(); --i)
-	//	Nodes[i].ComputeChildrenEnd(Nodes);
+
+	Engine::ThreadPool::GetShared().ParallelFor(arrays.size(), [&arrays, level](size_t i) { arrays[i]->Compress(level); });
+}
+
+void FbxFileStructure::StreamSections()
+{
+	if (Output == nullptr)
+		return;
+
+	for (; SectionsWritten < RootNode.ChildIndices.size(); ++SectionsWritten)
+	{
+		size_t index = RootNode.ChildIndices[SectionsWritten];
+
+		CompressArrays(index);
+
+		Nodes[index].Write(*Output, Nodes);
+	}
+}
+
+void FbxFileStructure::BeginObjects()
+{
+	if (Output == nullptr)
+		return;
+
+	// the objects node stays open until EndObjects, its children are written as they're finished
+	Nodes[Objects].WriteBegin(*Output);
+
+	++SectionsWritten;
+}
+
+void FbxFileStructure::StreamObjects(size_t last)
+{
+	if (Output == nullptr)
+		return;
+
+	FbxNode& objects = Nodes[Objects];
+
+	// objects go out in order, so writing one also writes the unfinished ones before it. nothing may be added to them afterwards
+	while (ObjectsWritten < objects.ChildIndices.size())
+	{
+		size_t index = objects.ChildIndices[ObjectsWritten++];
+
+		CompressArrays(index);
+
+		Nodes[index].Write(*Output, Nodes);
+
+		// once it's in the stream the subtree only needs its ids and names, its raw and compressed arrays can go
+		std::vector<size_t> nodeStack = { index };
+
+		while (nodeStack.size() > 0)
+		{
+			FbxNode& node = Nodes[nodeStack.back()];
+
+			nodeStack.pop_back();
+			node.Header.Properties.clear();
+			nodeStack.insert(nodeStack.end(), node.ChildIndices.begin(), node.ChildIndices.end());
+		}
+
+		if (index == last)
+			break;
+	}
+}
+
+void FbxFileStructure::EndObjects()
+{
+	if (Output == nullptr)
+		return;
+
+	StreamObjects((size_t)-1);
+
+	Nodes[Objects].WriteEnd(*Output);
+
+	// the counts were written before any objects were added, their values get patched over the placeholders
+	auto patchCount = [this](size_t index)
+	{
+		FbxNode& node = Nodes[index];
+		size_t position = (size_t)node.Header.StartOffset + 3 * sizeof(unsigned long long) + sizeof(unsigned char) + node.Header.Name.size() + 1;
+
+		Output->Patch(position, node.Header.Properties[0].Data.data(), sizeof(int));
+	};
+
+	patchCount(ObjectCount);
+
+	for (auto& definition : ObjectDefinitions)
+		patchCount(definition.second);
 }
 
 size_t FbxFileStructure::AddNode(const std::string& name, FbxNode* parent)
@@ -1597,13 +2002,13 @@ size_t FbxFileStructure::AddNode(const std::string& name, size_t parent, bool al
 
 	size_t index = Nodes.size();
 
-	Nodes.push_back(FbxNode());
+	Nodes.emplace_back(&Arena);
 
 	FbxNode& node = Nodes.back();
 	node.Index = index;
 	node.Parent = parent;
 	node.Depth = parent == -1 ? 1 : Nodes[parent].Depth + 1;
-	node.Header.Name = name;
+	node.Header.Name = Arena.Copy(name);
 
 	if (parent != -1)
 		Nodes[parent].ChildIndices.push_back(index);
@@ -3,11 +3,18 @@
 import <iostream>;
 import <vector>;
 import <map>;
+import <unordered_map>;
+import <string_view>;
+import <span>;
+import <memory_resource>;
 
-#include <Engine/Assets/ParserUtils.h>
+#include <Engine/Assets/BinaryReader.h>
+#include <Engine/MemoryArena.h>
 #include <Engine/Math/Matrix4-decl.h>
 #include "FbxPropertyHandler.h"
+#include "FbxExportSettings.h"
 #include "PackageNodes.h"
+#include "FbxIdMap.h"
 
 namespace Engine
 {
@@ -50,39 +57,88 @@ typedef FbxVersionEnum::FbxVersion FbxVersion;
 
 const Endian fbxEndian(std::endian::little);
 
+// either a span into the file being read or an owned buffer. spans get copied into owned storage the first time they're resized
+struct PropertyBuffer
+{
+	char* data() { return View != nullptr ? const_cast<char*>(View) : Storage.data(); }
+	const char* data() const { return View != nullptr ? View : Storage.data(); }
+	size_t size() const { return View != nullptr ? ViewLength : Storage.size(); }
+	bool IsView() const { return View != nullptr; }
+
+	char& operator[](size_t index) { return data()[index]; }
+	const char& operator[](size_t index) const { return data()[index]; }
+
+	void resize(size_t length);
+	void clear();
+	void shrink_to_fit();
+	void Reference(const char* data, size_t length);
+
+private:
+	const char* View = nullptr;
+	size_t ViewLength = 0;
+	std::vector<char> Storage;
+};
+
+// buffers output in chunks and lets header fields be filled in after the fact, seeking back on the stream only when the field was already flushed
+class FbxNodeStream
+{
+public:
+	FbxNodeStream() {}
+	FbxNodeStream(std::ostream& out, size_t chunkSize = 1 << 20);
+
+	size_t Tell() const { return Flushed + Buffer.size(); }
+	void Write(const char* data, size_t size);
+	void Patch(size_t position, const char* data, size_t size);
+	void Flush();
+
+private:
+	std::ostream* Out = nullptr;
+	std::streamoff Base = 0;
+	size_t Flushed = 0;
+	size_t ChunkSize = 0;
+	std::vector<char> Buffer;
+};
+
 struct NodeProperty
 {
 	char TypeCode = 0;
-	std::vector<char> Data;
-	std::vector<char> CompressedData;
+	PropertyBuffer Data;
+	PropertyBuffer CompressedData;
 	unsigned int ArrayLength = 0;
 	unsigned int Encoding = 0;
 	unsigned int CompressedLength = 0;
 
-	void PushData(std::istream& stream, int length);
-	void Write(std::ostream& out);
-	void Compress();
+	void PushData(const char* data, size_t length);
+	void Inflate();
+	void Write(FbxNodeStream& out);
+	void Compress(int level = -1);
 	void InsertData(const char* data, size_t length, size_t arrayLength = 0);
 
 	size_t GetSize() const;
+	size_t GetEntryLength() const;
+	bool IsArray() const { return TypeCode == 'f' || TypeCode == 'd' || TypeCode == 'l' || TypeCode == 'i' || TypeCode == 'b'; }
+	bool NeedsInflating() const { return Encoding != 0 && Data.size() == 0 && ArrayLength != 0; }
 
-	bool operator==(const std::string& text) const;
-	bool operator!=(const std::string& text) const;
+	bool operator==(std::string_view text) const;
+	bool operator!=(std::string_view text) const;
 };
 
 std::ostream& operator<<(std::ostream& out, const NodeProperty& property);
 
+// names read from a file view the file's buffer, ones added while building a file are copied into the structure's arena
 struct FbxNodeHeader
 {
-	std::string Name;
+	std::string_view Name;
 	unsigned long long NumProperties = 0;
 	unsigned long long EndOffset = 0;
 	unsigned long long StartOffset = 0;
 	unsigned long long PropertySize = 0;
 	unsigned char NameLength = 0;
-	std::vector<NodeProperty> Properties;
+	std::pmr::vector<NodeProperty> Properties;
 
-	void Read(std::istream& stream, unsigned int version, char* buffer);
+	FbxNodeHeader(std::pmr::memory_resource* arena = std::pmr::get_default_resource()) : Properties(arena) {}
+
+	void Read(BinaryReader& reader, unsigned int version);
 
 	bool IsNull() const;
 };
@@ -93,41 +149,79 @@ struct FbxObjectNode
 {
 	FbxNode* Parent = nullptr;
 	long long Id = 0;
+	size_t ObjectIndex = 0;
 	size_t MeshIndex = 0;
 	std::shared_ptr<Engine::Graphics::MeshData> Mesh;
 	std::shared_ptr<Engine::Graphics::MeshFormat> Format;
-	std::vector<FbxObjectNode*> ReferencedBy;
-	std::vector<FbxObjectNode*> References;
+	std::span<FbxObjectNode*> ReferencedBy;
+	std::span<FbxObjectNode*> References;
 	size_t BufferLength = 0;
 	int* IndexBuffer = nullptr;
 	double* WeightBuffer = nullptr;
 	Matrix4D Transformation;
 
-	FbxObjectNode* FindRef(const char* name, const char* type = nullptr);
-	FbxObjectNode* FindRefBy(const char* name, const char* type = nullptr);
+	FbxObjectNode* FindRef(std::string_view name, const char* type = nullptr);
+	FbxObjectNode* FindRefBy(std::string_view name, const char* type = nullptr);
 };
 
-std::string vectorToString(const std::vector<char>& vector);
+struct FbxNode;
+
+// built once over a parsed tree so child and object lookups are hashed instead of scanning and comparing strings
+class FbxNodeLookup
+{
+public:
+	void Build(std::vector<FbxNode>& nodes, FbxNode& root);
+	void Clear();
+
+	FbxNode* FindChild(const FbxNode* parent, std::string_view name) const;
+	FbxNode* FindChildWith(const FbxNode* parent, std::string_view text) const;
+	const std::vector<FbxNode*>& FindObjects(std::string_view className, std::string_view subType) const;
+
+private:
+	struct ChildKey
+	{
+		const FbxNode* Parent = nullptr;
+		std::string_view Text;
+
+		bool operator==(const ChildKey& other) const { return Parent == other.Parent && Text == other.Text; }
+	};
+
+	struct ChildKeyHash
+	{
+		size_t operator()(const ChildKey& key) const;
+	};
+
+	typedef std::pair<std::string_view, std::string_view> ObjectClass;
+
+	std::unordered_map<ChildKey, FbxNode*, ChildKeyHash> ChildrenByName;
+	std::unordered_map<ChildKey, FbxNode*, ChildKeyHash> ChildrenByTag;
+	std::map<ObjectClass, std::vector<FbxNode*>> ObjectsByClass;
+};
 
 struct FbxNode
 {
 	FbxNodeHeader Header;
 	std::unique_ptr<FbxObjectNode> ObjectNode;
+	const FbxNodeLookup* Lookup = nullptr;
 
 	size_t Index = 0;
 	size_t Parent = 0;
 	size_t Depth = 0;
 	bool ForceEndMarker = false;
-	std::vector<size_t> ChildIndices;
-	std::vector<FbxNode*> Children;
+	std::pmr::vector<size_t> ChildIndices;
+	std::pmr::vector<FbxNode*> Children;
+
+	FbxNode(std::pmr::memory_resource* arena = std::pmr::get_default_resource()) : Header(arena), ChildIndices(arena), Children(arena) {}
 
-	FbxNode* Find(const std::string& name);
-	FbxNode* FindWith(const std::string& text, size_t index = 0);
+	FbxNode* Find(std::string_view name);
+	FbxNode* FindWith(std::string_view text, size_t index = 0);
 	NodeProperty* GetProperty(size_t index);
+	std::string_view GetStringProperty(size_t index) const;
 	FbxObjectNode* MakeObjectNode();
 
-	void Write(std::ostream& out);
-	void ComputeEnd(size_t start, std::vector<FbxNode>& nodes);
+	void Write(FbxNodeStream& out, std::vector<FbxNode>& nodes);
+	void WriteBegin(FbxNodeStream& out);
+	void WriteEnd(FbxNodeStream& out);
 	void ComputeChildrenEnd(std::vector<FbxNode>& nodes);
 
 	template <typename T>
@@ -143,7 +237,7 @@ struct FbxNode
 	}
 
 	template <typename T>
-	bool ReadChildWithPropertySafe(const std::string& name, size_t index, T& output, size_t tagIndex = 0)
+	bool ReadChildWithPropertySafe(std::string_view name, size_t index, T& output, size_t tagIndex = 0)
 	{
 		FbxNode* child = FindWith(name, tagIndex);
 
@@ -153,7 +247,7 @@ struct FbxNode
 	}
 
 	template <typename T>
-	T ReadChildWithProperty(const std::string& name, size_t index, size_t tagIndex = 0)
+	T ReadChildWithProperty(std::string_view name, size_t index, size_t tagIndex = 0)
 	{
 		FbxNode* child = FindWith(name, tagIndex);
 
@@ -210,14 +304,21 @@ struct FbxFileStructure
 {
 	bool DebugPrint = false;
 
-	FbxNode RootNode;
+	// the node tree's lists and names live here so it can all be dropped at once, it has to outlive everything below it
+	Engine::MemoryArena Arena;
+	FbxNode RootNode = FbxNode(&Arena);
 	std::vector<FbxNode> Nodes;
-	std::map<long long, FbxNode*> FbxObjectNodes;
+	FbxIdMap<FbxNode*> FbxObjectNodes;
+	FbxNodeLookup Lookup;
+	std::vector<FbxObjectNode*> ObjectReferences;
+	std::vector<FbxObjectNode*> ObjectReferencedBy;
+	std::vector<FbxNode*> RootObjects;
 	std::vector<FbxConnection> ObjectConnections;
 	std::vector<FbxObject> FbxObjects;
 	std::vector<FbxMaterial> FbxMaterials;
 	std::map<std::string, size_t> ObjectDefinitions;
 	Engine::Graphics::ModelPackage* Package = nullptr;
+	FbxExportSettings Settings;
 
 	FbxTimeStamp TimeStamp;
 
@@ -235,10 +336,25 @@ struct FbxFileStructure
 
 	size_t ObjectCount = (size_t)-1;
 
-	void ReadNodes(std::istream& stream);
-	void WriteNodes(std::ostream& stream);
+	// set while StreamFile runs. sections and objects are written out as soon as they're finished, the definition counts get patched in once all of the objects are known
+	FbxNodeStream* Output = nullptr;
+	size_t SectionsWritten = 0;
+	size_t ObjectsWritten = 0;
+
+	FbxFileStructure(size_t arenaBlockSize = Engine::MemoryArena::DefaultBlockSize) : Arena(arenaBlockSize) {}
+
+	void ReadNodes(const char* data, size_t size);
+	void LinkObjects();
+	void InflateArrays();
+	void StreamFile(std::ostream& stream);
 	void MakeFileStructure();
-	void FinalizeNodes();
+	void CompressArrays(size_t root);
+	void WriteFileHeader(FbxNodeStream& stream);
+	void WriteFileFooter(FbxNodeStream& stream);
+	void StreamSections();
+	void BeginObjects();
+	void StreamObjects(size_t last);
+	void EndObjects();
 	size_t AddNode(const std::string& name, FbxNode* parent = nullptr);
 	size_t AddNode(const std::string& name, size_t parent, bool allowNull = false);
 	size_t AddDefinition(const std::string& typeName);
@@ -286,6 +402,8 @@ struct FbxFileStructure
 	template <typename... T>
 	size_t AddProperties(size_t node, const T&... properties)
 	{
+		Node(node)->Header.Properties.reserve(Node(node)->Header.Properties.size() + sizeof...(T));
+
 		(AddProperty(node, properties), ...);
 
 		return node;
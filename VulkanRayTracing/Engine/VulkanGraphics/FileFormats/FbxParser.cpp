@@ -2,7 +2,7 @@
 
 import <vector>;
 import <iostream>;
-import <map>;
+import <algorithm>;
 
 #include <Engine/Assets/ParserUtils.h>
 #include <Engine/Math/Matrix4.h>
@@ -18,23 +18,7 @@ using Engine::Graphics::VertexAttributeFormat;
 
 std::shared_ptr<Engine::Graphics::MeshFormat> GetMeshFormat(const std::vector<Engine::Graphics::VertexAttributeFormat>& attributes)
 {
-	std::string hashString;
-
-	Engine::Graphics::VertexAttributeFormat::GetHashString(hashString, attributes);
-
-	std::shared_ptr<Engine::Graphics::MeshFormat> meshFormat = Engine::Graphics::MeshFormat::GetCachedFormat(hashString);
-
-	if (meshFormat == nullptr)
-	{
-		meshFormat = Engine::Create<Engine::Graphics::MeshFormat>();
-
-		for (size_t i = 0; i < attributes.size(); ++i)
-			meshFormat->Push(attributes[i]);
-
-		Engine::Graphics::MeshFormat::CacheFormat(hashString, meshFormat);
-	}
-
-	return meshFormat;
+	return Engine::Graphics::MeshFormat::GetFormat(attributes);
 }
 
 struct FbxGlobalSettings
@@ -118,11 +102,29 @@ struct FbxNodeData
 
 void FbxParser::Parse(std::istream& stream)
 {
-	FbxFileStructure fbxFile;
+	std::vector<char> buffer;
+
+	stream.seekg(0, std::ios::end);
 
-	fbxFile.ReadNodes(stream);
+	std::streamoff size = stream.tellg();
 
-	std::vector<FbxNode*> fbxRootNodes;
+	stream.seekg(0, std::ios::beg);
+
+	if (size > 0)
+	{
+		buffer.resize((size_t)size);
+		stream.read(buffer.data(), size);
+		buffer.resize((size_t)stream.gcount());
+	}
+
+	Parse(buffer.data(), buffer.size());
+}
+
+void FbxParser::Parse(const char* data, size_t size)
+{
+	FbxFileStructure fbxFile;
+
+	fbxFile.ReadNodes(data, size);
 
 	auto tabs = [](std::ostream& stream, size_t count) -> std::ostream&
 	{
@@ -140,7 +142,7 @@ void FbxParser::Parse(std::istream& stream)
 		{
 			if (DebugPrint)
 			{
-				tabs(std::cout, node.Depth) << (node.Header.Name.size() == 0 ? std::string("<Node>") : node.Header.Name) << " [ ";
+				tabs(std::cout, node.Depth) << (node.Header.Name.size() == 0 ? std::string_view("<Node>") : node.Header.Name) << " [ ";
 
 				if (node.Header.Properties.size() > 0)
 				{
@@ -165,84 +167,43 @@ void FbxParser::Parse(std::istream& stream)
 
 	settings.Fetch(fbxFile.RootNode.Find("GlobalSettings"));
 
-	FbxNode* objectsNode = fbxFile.RootNode.Find("Objects");
-	
-	for (size_t i = 0; i < objectsNode->Children.size(); ++i)
-	{
-		FbxNode* node = objectsNode->Children[i];
-
-		long long id = fbxEndian.read<long long>(node->Header.Properties[0].Data.data());
+	fbxFile.LinkObjects();
 
-		fbxFile.FbxObjectNodes[id] = node;
-	}
-
-	for (size_t i = 0; i < objectsNode->Children.size(); ++i)
-	{
-		FbxNode* node = objectsNode->Children[i];
-		FbxObjectNode* fbxNode = node->MakeObjectNode();
+	FbxNode* objectsNode = fbxFile.RootNode.Find("Objects");
 
-		long long id = fbxEndian.read<long long>(node->Header.Properties[0].Data.data());
+	if (objectsNode == nullptr)
+		throw "fbx file has no objects";
 
-		fbxNode->Id = id;
-	}
+	FbxIdMap<size_t> packageNodes;
 
-	FbxNode* connectionsNode = fbxFile.RootNode.Find("Connections");
+	packageNodes.Reserve(objectsNode->Children.size());
 
-	if (connectionsNode != nullptr)
+	auto getNodeIndex = [this, &packageNodes](long long nodeId) -> size_t
 	{
-		for (size_t i = 0; i < connectionsNode->Children.size(); ++i)
-		{
-			FbxNode* connection = connectionsNode->Children[i];
-
-			long long id1 = fbxEndian.read<long long>(connection->Header.Properties[1].Data.data());
-			long long id2 = fbxEndian.read<long long>(connection->Header.Properties[2].Data.data());
+		size_t* mapIndex = packageNodes.Find(nodeId);
 
-			auto index1 = fbxFile.FbxObjectNodes.find(id1);
-			auto index2 = fbxFile.FbxObjectNodes.find(id2);
+		if (mapIndex != nullptr)
+			return *mapIndex;
 
-			if (index1 != fbxFile.FbxObjectNodes.end() && index2 != fbxFile.FbxObjectNodes.end())
-			{
-				index1->second->ObjectNode->ReferencedBy.push_back(index2->second->ObjectNode.get());
-				index2->second->ObjectNode->References.push_back(index1->second->ObjectNode.get());
-			}
-			else if (id2 == 0)
-				fbxRootNodes.push_back(index1->second);
-		}
-	}
-
-	std::map<long long, size_t> packageNodes;
-	std::map<long long, size_t> packageNodeParents;
-
-	auto getNodeIndex = [this, &packageNodes](long long nodeId) -> size_t
-	{
-		size_t index = 0;
-		auto mapIndex = packageNodes.find(nodeId);
+		size_t index = Package->Nodes.size();
 
-		if (mapIndex == packageNodes.end())
-		{
-			index = Package->Nodes.size();
-			packageNodes[nodeId] = index;
-			Package->Nodes.push_back(Engine::Graphics::ModelPackageNode());
-		}
-		else
-			index = mapIndex->second;
+		packageNodes[nodeId] = index;
+		Package->Nodes.push_back(Engine::Graphics::ModelPackageNode());
 
 		return index;
 	};
 
 	auto getMaterialNodeIndex = [this, &packageNodes](long long nodeId) -> size_t
 	{
-		size_t index = 0;
-		auto mapIndex = packageNodes.find(nodeId);
+		size_t* mapIndex = packageNodes.Find(nodeId);
 
-		if (mapIndex == packageNodes.end())
-		{
-			index = Package->Materials.size();
-			packageNodes[nodeId] = index;
-			Package->Materials.push_back(Engine::Graphics::ModelPackageMaterial());
-		}
-		else
-			index = mapIndex->second;
+		if (mapIndex != nullptr)
+			return *mapIndex;
+
+		size_t index = Package->Materials.size();
+
+		packageNodes[nodeId] = index;
+		Package->Materials.push_back(Engine::Graphics::ModelPackageMaterial());
 
 		return index;
 	};
@@ -258,10 +219,7 @@ void FbxParser::Parse(std::istream& stream)
 		std::shared_ptr<Engine::Graphics::MeshFormat> format;
 		std::shared_ptr<Engine::Graphics::MeshData> data;
 
-		std::string objectType;
-
-		if (node->Header.Properties.size() >= 2 && node->Header.Properties[2].TypeCode == 'S')
-			objectType = vectorToString(node->Header.Properties[2].Data);
+		std::string_view objectType = node->GetStringProperty(2);
 
 		if (node->Header.Name == "NodeAttribute")
 		{
@@ -372,11 +330,11 @@ void FbxParser::Parse(std::istream& stream)
 
 					if (mapping != nullptr)
 					{
-						std::string type = vectorToString(mapping->Header.Properties[0].Data);
+						std::string_view type = mapping->GetStringProperty(0);
 
 						if (type != "ByVertice" && type != "ByPolygonVertex")
 						{
-							std::cout << "attribute '" << index << "' unsupported mapping type: '" << vectorToString(mapping->Header.Properties[0].Data) << std::endl;
+							std::cout << "attribute '" << index << "' unsupported mapping type: '" << type << std::endl;
 							return nullptr;
 						}
 					}
@@ -385,7 +343,7 @@ void FbxParser::Parse(std::istream& stream)
 
 					if (referenceType != nullptr)
 					{
-						std::string type = vectorToString(referenceType->Header.Properties[0].Data);
+						std::string_view type = referenceType->GetStringProperty(0);
 
 						if (type == "IndexToDirect")
 						{
@@ -411,21 +369,18 @@ void FbxParser::Parse(std::istream& stream)
 
 				FbxNode* shapeKeyGeometry = nullptr;
 
-				for (size_t i = 0; i < node->ObjectNode->References.size(); ++i)
+				FbxObjectNode* blendShape = fbxNode->FindRef("Deformer", "BlendShape");
+
+				if (blendShape != nullptr)
 				{
-					FbxObjectNode* blendShape = node->ObjectNode->FindRef("Deformer", "BlendShape");
+					FbxObjectNode* blendShapeChannel = blendShape->FindRef("Deformer", "BlendShapeChannel");
 
-					if (blendShape != nullptr)
+					if (blendShapeChannel != nullptr)
 					{
-						FbxObjectNode* blendShapeChannel = blendShape->FindRef("Deformer", "BlendShapeChannel");
-
-						if (blendShapeChannel != nullptr)
-						{
-							FbxObjectNode* shapeKey = blendShapeChannel->FindRef("Geometry", "Shape");
+						FbxObjectNode* shapeKey = blendShapeChannel->FindRef("Geometry", "Shape");
 
-							if (shapeKey != nullptr)
-								shapeKeyGeometry = shapeKey->Parent;
-						}
+						if (shapeKey != nullptr)
+							shapeKeyGeometry = shapeKey->Parent;
 					}
 				}
 
@@ -593,12 +548,16 @@ void FbxParser::Parse(std::istream& stream)
 		if (Package->Nodes[i].AttachedTo != (size_t)-1)
 			Package->Nodes[i].Transform->SetParent(Package->Nodes[Package->Nodes[i].AttachedTo].Transform);
 
-	for (auto index : fbxFile.FbxObjectNodes)
+	// several clusters can point at the same geometry and the last one wins, so they go in object id order like the old scan over every object did
+	std::vector<FbxNode*> clusters = fbxFile.Lookup.FindObjects("Deformer", "Cluster");
+
+	std::sort(clusters.begin(), clusters.end(), [](FbxNode* left, FbxNode* right) { return left->ObjectNode->Id < right->ObjectNode->Id; });
+
+	for (size_t k = 0; k < clusters.size(); ++k)
 	{
-		FbxNode* node = index.second;
-		FbxObjectNode* object = node->ObjectNode.get();
+		FbxObjectNode* object = clusters[k]->ObjectNode.get();
 
-		if (node->Header.Name == "Deformer" && object->BufferLength != 0)
+		if (object->BufferLength != 0)
 		{
 			for (size_t i = 0; i < object->ReferencedBy.size(); ++i)
 			{
@@ -32,4 +32,5 @@ public:
 	Engine::Graphics::ModelPackage* Package = nullptr;
 
 	void Parse(std::istream& stream);
+	void Parse(const char* data, size_t size);
 };
\ No newline at end of file
@@ -3,13 +3,9 @@
 
 void AddFbxNodeProperty(FbxNode* node, char typeCode, const char* data, size_t length, size_t arrayLength, bool shouldCompress)
 {
-	shouldCompress = length >= 1024;
-
+	// arrays get compressed all at once by FbxFileStructure::CompressArrays right before their subtree is streamed out
 	node->Header.Properties.push_back(NodeProperty{ typeCode });
 	node->Header.Properties.back().InsertData(data, length, arrayLength);
-
-	if (shouldCompress)
-		node->Header.Properties.back().Compress();
 }
 
 char* GetFbxPropertyData(NodeProperty* property)
@@ -9,8 +9,7 @@ void FbxWriter::Write(std::ostream& out)
 	fbxFile.FbxObjects = FbxObjects;
 	fbxFile.FbxMaterials = FbxMaterials;
 	fbxFile.Package = Package;
+	fbxFile.Settings = Settings;
 
-	fbxFile.MakeFileStructure();
-	fbxFile.FinalizeNodes();
-	fbxFile.WriteNodes(out);
+	fbxFile.StreamFile(out);
 }
\ No newline at end of file
@@ -11,6 +11,7 @@ public:
 	std::vector<FbxObject> FbxObjects;
 	std::vector<FbxMaterial> FbxMaterials;
 	Engine::Graphics::ModelPackage* Package = nullptr;
+	FbxExportSettings Settings;
 
 	void Write(std::ostream& out);
 };
\ No newline at end of file
@@ -17,61 +17,79 @@ BlockData& NifDocument::InitializeBlock(unsigned int blockIndex)
 	return block;
 }
 
+size_t NifDocument::GetArenaAllocationCount() const
+{
+	size_t count = 0;
+
+	for (size_t i = 0; i < Arenas.size(); ++i)
+		count += Arenas[i]->GetAllocationCount();
+
+	return count;
+}
+
+size_t NifDocument::GetArenaBlockCount() const
+{
+	size_t count = 0;
+
+	for (size_t i = 0; i < Arenas.size(); ++i)
+		count += Arenas[i]->GetBlockCount();
+
+	return count;
+}
+
 const BlockData* NifDocument::FetchRef(unsigned int ref)
 {
 	if (ref == 0xFFFFFFFFu) return nullptr;
 
+	if (ref >= Blocks.size())
+		throw "nif block ref out of range";
+
 	return &Blocks[ref];
 }
 
-const BlockData* NifDocument::FetchRef(std::istream& stream)
+const BlockData* NifDocument::FetchRef(BinaryReader& stream)
 {
-	return FetchRef(Endian.read<unsigned int>(stream));
+	return FetchRef(stream.read<unsigned int>());
 }
 
 const std::string& NifDocument::FetchString(unsigned int ref)
 {
-	static const std::string emptyString;
-
-	if (ref == 0xFFFFFFFFu) return emptyString;
-
-	return Strings[ref];
+	return Strings.Fetch(ref);
 }
 
-const std::string& NifDocument::FetchString(std::istream& stream)
+const std::string& NifDocument::FetchString(BinaryReader& stream)
 {
-	return FetchString(Endian.read<unsigned int>(stream));
+	return FetchString(stream.read<unsigned int>());
 }
 
-void NifDocument::ReadBlockRefs(std::istream& stream, BlockData& block, std::vector<const BlockData*>& refs)
+void NifDocument::ReadBlockRefs(BinaryReader& stream, BlockData& block, NifArray<const BlockData*>& refs)
 {
-	unsigned int count = Endian.read<unsigned int>(stream);
+	unsigned int count = stream.read<unsigned int>();
 
 	refs.resize(count);
 
 	for (unsigned int i = 0; i < count; ++i)
-		refs[i] = &Blocks[Endian.read<unsigned int>(stream)];
+		refs[i] = FetchRef(stream);
 }
 
 std::shared_ptr<Engine::Graphics::MeshFormat> GetNiMeshFormat()
 {
-	static std::shared_ptr<Engine::Graphics::MeshFormat> format = nullptr;
-
-	if (format != nullptr)
-		return format;
-
-	using Engine::Graphics::VertexAttributeFormat;
-
-	std::vector<Engine::Graphics::VertexAttributeFormat> attributes;
-
-	attributes.push_back(VertexAttributeFormat{ Enum::AttributeDataType::Float32, 3, "position", 0 });
-	attributes.push_back(VertexAttributeFormat{ Enum::AttributeDataType::Float32, 3, "normal", 1 });
-	attributes.push_back(VertexAttributeFormat{ Enum::AttributeDataType::Float32, 2, "textureCoords", 1 });
-	attributes.push_back(VertexAttributeFormat{ Enum::AttributeDataType::Float32, 3, "binormal", 1 });
-	attributes.push_back(VertexAttributeFormat{ Enum::AttributeDataType::Float32, 3, "tangent", 1 });
-	attributes.push_back(VertexAttributeFormat{ Enum::AttributeDataType::Float32, 3, "morphPosition1", 2 });
-
-	format = Engine::Graphics::MeshFormat::GetFormat(attributes);
+	// function local static init is thread safe, so the format only ever gets built once
+	static std::shared_ptr<Engine::Graphics::MeshFormat> format = []()
+	{
+		using Engine::Graphics::VertexAttributeFormat;
+
+		std::vector<Engine::Graphics::VertexAttributeFormat> attributes;
+
+		attributes.push_back(VertexAttributeFormat{ Enum::AttributeDataType::Float32, 3, "position", 0 });
+		attributes.push_back(VertexAttributeFormat{ Enum::AttributeDataType::Float32, 3, "normal", 1 });
+		attributes.push_back(VertexAttributeFormat{ Enum::AttributeDataType::Float32, 2, "textureCoords", 1 });
+		attributes.push_back(VertexAttributeFormat{ Enum::AttributeDataType::Float32, 3, "binormal", 1 });
+		attributes.push_back(VertexAttributeFormat{ Enum::AttributeDataType::Float32, 3, "tangent", 1 });
+		attributes.push_back(VertexAttributeFormat{ Enum::AttributeDataType::Float32, 3, "morphPosition1", 2 });
+
+		return Engine::Graphics::MeshFormat::GetFormat(attributes);
+	}();
 
 	return format;
 }
\ No newline at end of file
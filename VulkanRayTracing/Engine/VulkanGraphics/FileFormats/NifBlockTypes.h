@@ -5,7 +5,9 @@ import <string>;
 import <memory>;
 import <limits>;
 
-#include <Engine/Assets/ParserUtils.h>
+#include <Engine/Assets/BinaryReader.h>
+#include <Engine/Assets/BinaryWriter.h>
+#include <Engine/MemoryArena.h>
 #include <Engine/Math/Vector2S.h>
 #include <Engine/Math/Vector3S.h>
 #include <Engine/Math/Vector3S.h>
@@ -15,10 +17,15 @@ import <limits>;
 #include <Engine/Math/Quaternion.h>
 #include <Engine/VulkanGraphics/Scene/MeshData.h>
 #include "NifComponentInfo.h"
+#include "NifStringTable.h"
 
 struct BlockData;
 struct NifDocument;
 
+// block arrays come out of whichever arena the block was parsed under
+template <typename T>
+using NifArray = std::vector<T, Engine::ArenaAllocator<T>>;
+
 struct NiDataBlock {
 	unsigned int BlockIndex = 0;
 	NifDocument* Document = nullptr;
@@ -40,6 +47,21 @@ struct NiDataBlock {
 	}
 };
 
+// block data is placed in whatever memory resource was scoped when it was made, so it has to be handed back there
+struct NiDataBlockDelete
+{
+	std::pmr::memory_resource* Resource = nullptr;
+	size_t Size = 0;
+	size_t Alignment = 0;
+
+	void operator()(NiDataBlock* data) const
+	{
+		data->~NiDataBlock();
+
+		Resource->deallocate(data, Size, Alignment);
+	}
+};
+
 struct BlockData
 {
 	std::string BlockType;
@@ -47,20 +69,31 @@ struct BlockData
 	NifDocument* Document = nullptr;
 	unsigned int BlockIndex = 0;
 	unsigned int BlockSize = 0;
-	std::unique_ptr<NiDataBlock> Data = nullptr;
+	std::unique_ptr<NiDataBlock, NiDataBlockDelete> Data = nullptr;
 	unsigned int BlockStart = 0;
 
 	template <typename T, typename... Arguments>
 	T* AddData(const Arguments&... arguments)
 	{
-		std::unique_ptr<T> data = std::make_unique<T>(arguments...);
-	
-		data->BlockIndex = BlockIndex;
-		data->Document = Document;
+		std::pmr::memory_resource* resource = Engine::MemoryArena::GetScoped();
+		void* memory = resource->allocate(sizeof(T), alignof(T));
+		T* pointer = nullptr;
+
+		try
+		{
+			pointer = new (memory) T(arguments...);
+		}
+		catch (...)
+		{
+			resource->deallocate(memory, sizeof(T), alignof(T));
+
+			throw;
+		}
 	
-		T* pointer = data.get();
+		pointer->BlockIndex = BlockIndex;
+		pointer->Document = Document;
 	
-		Data = std::move(data);
+		Data = std::unique_ptr<NiDataBlock, NiDataBlockDelete>(pointer, NiDataBlockDelete{ resource, sizeof(T), alignof(T) });
 		
 		return pointer;
 	}
@@ -124,11 +157,11 @@ struct NiTransform
 
 struct NiNodeType : public NiDataBlock
 {
-	std::vector<const BlockData*> ExtraData;
+	NifArray<const BlockData*> ExtraData;
 	const BlockData* Controller = nullptr;
 	unsigned short Flags = 0;
 	NiTransform Transformation;
-	std::vector<const BlockData*> Properties;
+	NifArray<const BlockData*> Properties;
 	const BlockData* CollisionObject = nullptr;
 };
 
@@ -136,8 +169,8 @@ struct NiNode : public NiNodeType
 {
 	static inline const std::string BlockTypeName = "NiNode";
 
-	std::vector<const BlockData*> Children;
-	std::vector<const BlockData*> Effects;
+	NifArray<const BlockData*> Children;
+	NifArray<const BlockData*> Effects;
 };
 
 struct NiBounds
@@ -160,20 +193,20 @@ struct NiMesh : public NiNodeType
 	{
 		const BlockData* Stream = nullptr;
 		bool IsPerInstance = false;
-		std::vector<unsigned short> SubmeshToRegionMap;
-		std::vector<Semantics> ComponentSemantics;
+		NifArray<unsigned short> SubmeshToRegionMap;
+		NifArray<Semantics> ComponentSemantics;
 	};
 
-	std::vector<std::string> Materials;
-	std::vector<const BlockData*> MaterialExtraData;
+	NifArray<std::string> Materials;
+	NifArray<const BlockData*> MaterialExtraData;
 	unsigned int ActiveMaterial = 0;
 	bool MaterialNeedsUpdate = false;
 	MeshPrimitiveType PrimitiveType;
 	unsigned short NumSubmeshes = 0;
 	bool InstancingEnabled = false;
 	NiBounds Bounds;
-	std::vector<DataStreams> Streams;
-	std::vector<const BlockData*> Modifiers;
+	NifArray<DataStreams> Streams;
+	NifArray<const BlockData*> Modifiers;
 };
 
 struct NiMorphMeshModifier : public NiDataBlock
@@ -186,11 +219,11 @@ struct NiMorphMeshModifier : public NiDataBlock
 		unsigned int NormalizeFlag = 0;
 	};
 
-	std::vector<unsigned short> SubmitPoints;
-	std::vector<unsigned short> CompletePoints;
+	NifArray<unsigned short> SubmitPoints;
+	NifArray<unsigned short> CompletePoints;
 	unsigned char Flags = 0;
 	unsigned short NumTargets = 0;
-	std::vector<ElementData> Elements;
+	NifArray<ElementData> Elements;
 };
 
 struct NiMorphWeightsController : public NiDataBlock
@@ -205,8 +238,8 @@ struct NiMorphWeightsController : public NiDataBlock
 	float StopTime = 1e-5f;
 	const BlockData* Target = nullptr;
 	unsigned int Count = 0;
-	std::vector<const BlockData*> Interpolators;
-	std::vector<std::string> TargetNames;
+	NifArray<const BlockData*> Interpolators;
+	NifArray<std::string> TargetNames;
 };
 
 struct NiSkinningMeshModifier : public NiDataBlock
@@ -219,14 +252,14 @@ struct NiSkinningMeshModifier : public NiDataBlock
 		unsigned int NormalizeFlag = 0;
 	};
 
-	std::vector<unsigned short> SubmitPoints;
-	std::vector<unsigned short> CompletePoints;
+	NifArray<unsigned short> SubmitPoints;
+	NifArray<unsigned short> CompletePoints;
 	unsigned short Flags = 0;
 	const BlockData* SkeletonRoot = nullptr;
 	NiTransform SkeletonTransformation;
-	std::vector<const BlockData*> Bones;
-	std::vector<NiTransform> BoneTransforms;
-	std::vector<NiBounds> BoneBounds;
+	NifArray<const BlockData*> Bones;
+	NifArray<NiTransform> BoneTransforms;
+	NifArray<NiBounds> BoneBounds;
 };
 
 struct NiFloatInterpolator : public NiDataBlock
@@ -249,14 +282,14 @@ struct NiFloatData : public NiDataBlock
 
 	unsigned int Interpolation = 0;
 
-	std::vector<Key> Keys;
+	NifArray<Key> Keys;
 };
 
 struct NiMaterialProperty : public NiDataBlock
 {
 	static inline const std::string BlockTypeName = "NiMaterialProperty";
 
-	std::vector<const BlockData*> ExtraData;
+	NifArray<const BlockData*> ExtraData;
 	const BlockData* Controller = nullptr;
 	Color3 AmbientColor = Color3(0.7f, 0.7f, 0.7f);
 	Color3 DiffuseColor = Color3(0.7f, 0.7f, 0.7f);
@@ -290,7 +323,7 @@ struct NiTexturingProperty : public NiDataBlock
 		unsigned int MapId = 0;
 	};
 
-	std::vector<const BlockData*> ExtraData;
+	NifArray<const BlockData*> ExtraData;
 	const BlockData* Controller = nullptr;
 	unsigned short Flags = 0;
 	unsigned int TextureCount = 0;
@@ -307,14 +340,14 @@ struct NiTexturingProperty : public NiDataBlock
 	TextureData NormalTexture;
 	TextureData ParallaxTexture;
 	TextureData Decal0Texture;
-	std::vector<ShaderTextureData> ShaderTextures;
+	NifArray<ShaderTextureData> ShaderTextures;
 };
 
 struct NiSourceTexture : public NiDataBlock
 {
 	static inline const std::string BlockTypeName = "NiSourceTexture";
 
-	std::vector<const BlockData*> ExtraData;
+	NifArray<const BlockData*> ExtraData;
 	const BlockData* Controller = nullptr;
 	unsigned char UseExternal = 1;
 	std::string FileName;
@@ -356,7 +389,7 @@ struct NiIntegerExtraData : public NiExtraData<unsigned int>
 
 struct NiProperty : public NiDataBlock
 {
-	std::vector<const BlockData*> ExtraData;
+	NifArray<const BlockData*> ExtraData;
 	const BlockData* Controller = nullptr;
 	unsigned short Flags = 0;
 };
@@ -408,12 +441,15 @@ struct NiDataStream : public NiDataBlock
 
 	unsigned int StreamSize = 0;
 	CloningBehavior CloningBehavior;
-	std::vector<Region> Regions;
-	std::vector<ComponentFormat> ComponentFormats;
-	std::vector<char> StreamData;
+	NifArray<Region> Regions;
+	NifArray<ComponentFormat> ComponentFormats;
+	NifArray<char> StreamData;
+	const char* StreamView = nullptr;
 	StreamUsage Usage;
 	bool Streamable = false;
-	std::vector<Engine::Graphics::VertexAttributeFormat> Attributes;
+	NifArray<Engine::Graphics::VertexAttributeFormat> Attributes;
+
+	const char* GetStreamData() const { return StreamView != nullptr ? StreamView : StreamData.data(); }
 };
 
 struct CycleTypeEnum
@@ -451,7 +487,7 @@ struct NiSequenceData : public NiDataBlock
 {
 	static inline const std::string BlockTypeName = "NiSequenceData";
 
-	std::vector<const BlockData*> Evaluators;
+	NifArray<const BlockData*> Evaluators;
 	const BlockData* TextKeys = nullptr;
 	float Duration = 0;
 	CycleType CycleType;
@@ -528,8 +564,8 @@ struct NiBSpineData : public NiDataBlock
 {
 	static inline const std::string BlockTypeName = "NiBSpineData";
 
-	std::vector<float> FloatControlPoints;
-	std::vector<short> CompactControlPoints;
+	NifArray<float> FloatControlPoints;
+	NifArray<short> CompactControlPoints;
 };
 
 struct NiBSplineBasisData : public NiDataBlock
@@ -564,16 +600,16 @@ typedef RotationTypeEnum::RotationType RotationType;
 struct NifDocument;
 
 template <typename KeyType>
-KeyType ParseKey(NifDocument* document, std::istream& stream);
+KeyType ParseKey(NifDocument* document, BinaryReader& stream);
 
 template <>
-float ParseKey<float>(NifDocument* document, std::istream& stream);
+float ParseKey<float>(NifDocument* document, BinaryReader& stream);
 
 template <>
-Quaternion ParseKey<Quaternion>(NifDocument* document, std::istream& stream);
+Quaternion ParseKey<Quaternion>(NifDocument* document, BinaryReader& stream);
 
 template <>
-Vector3F ParseKey<Vector3F>(NifDocument* document, std::istream& stream);
+Vector3F ParseKey<Vector3F>(NifDocument* document, BinaryReader& stream);
 
 template <typename KeyType>
 struct LinearKey
@@ -583,7 +619,7 @@ struct LinearKey
 	float Time;
 	KeyType Value;
 
-	void Parse(NifDocument* document, std::istream& stream);
+	void Parse(NifDocument* document, BinaryReader& stream);
 };
 
 template <typename KeyType>
@@ -596,7 +632,7 @@ struct QuadraticKey
 	KeyType Forward;
 	KeyType Backward;
 
-	void Parse(NifDocument* document, std::istream& stream);
+	void Parse(NifDocument* document, BinaryReader& stream);
 };
 
 template <typename KeyType>
@@ -610,29 +646,29 @@ struct TbcKey
 	float Bias;
 	float Continuity;
 
-	void Parse(NifDocument* document, std::istream& stream);
+	void Parse(NifDocument* document, BinaryReader& stream);
 };
 
 template <typename KeyType>
 struct Keys
 {
 	RotationType Interpolation;
-	std::vector<KeyType> KeysValues;
+	NifArray<KeyType> KeysValues;
 
-	void Parse(NifDocument* document, std::istream& stream);
+	void Parse(NifDocument* document, BinaryReader& stream);
 };
 
 template <typename KeyType>
 struct AnyKeysNoRotate
 {
 	RotationType Interpolation;
-	std::vector<LinearKey<KeyType>> LinearKeys;
-	std::vector<QuadraticKey<KeyType>> QuadraticKeys;
-	std::vector<TbcKey<KeyType>> TbcKeys;
+	NifArray<LinearKey<KeyType>> LinearKeys;
+	NifArray<QuadraticKey<KeyType>> QuadraticKeys;
+	NifArray<TbcKey<KeyType>> TbcKeys;
 
 	template <typename KeyContainer>
-	void ParseKeyVector(NifDocument* document, std::istream& stream, KeyContainer& container, unsigned int keys);
-	void Parse(NifDocument* document, std::istream& stream);
+	void ParseKeyVector(NifDocument* document, BinaryReader& stream, KeyContainer& container, unsigned int keys);
+	void Parse(NifDocument* document, BinaryReader& stream);
 };
 
 struct XyzKeys
@@ -643,7 +679,7 @@ struct XyzKeys
 	AnyKeysNoRotate<float> KeysY;
 	AnyKeysNoRotate<float> KeysZ;
 
-	void Parse(NifDocument* document, std::istream& stream)
+	void Parse(NifDocument* document, BinaryReader& stream)
 	{
 		KeysX.Parse(document, stream);
 		KeysY.Parse(document, stream);
@@ -655,14 +691,14 @@ template <typename KeyType>
 struct AnyKeys
 {
 	RotationType Interpolation;
-	std::vector<LinearKey<KeyType>> LinearKeys;
-	std::vector<QuadraticKey<KeyType>> QuadraticKeys;
-	std::vector<TbcKey<KeyType>> TbcKeys;
-	std::vector<XyzKeys> XyzKeys;
+	NifArray<LinearKey<KeyType>> LinearKeys;
+	NifArray<QuadraticKey<KeyType>> QuadraticKeys;
+	NifArray<TbcKey<KeyType>> TbcKeys;
+	NifArray<XyzKeys> XyzKeys;
 
 	template <typename KeyContainer>
-	void ParseKeyVector(NifDocument* document, std::istream& stream, KeyContainer& container, unsigned int keys);
-	void Parse(NifDocument* document, std::istream& stream);
+	void ParseKeyVector(NifDocument* document, BinaryReader& stream, KeyContainer& container, unsigned int keys);
+	void Parse(NifDocument* document, BinaryReader& stream);
 };
 
 struct NiTransformData : public NiDataBlock
@@ -684,61 +720,71 @@ struct NiTextKeyExtraData : public NiDataBlock
 {
 	static inline const std::string BlockTypeName = "NiTextKeyExtraData";
 
-	std::vector<TextKey> TextKeys;
+	NifArray<TextKey> TextKeys;
 };
 
 struct NifDocument
 {
-	typedef void (NifDocument::* BlockParseFunction)(std::istream& stream, BlockData& block);
-	typedef void (NifDocument::* BlockWriteFunction)(std::ostream& stream, BlockData& block);
+	typedef void (NifDocument::* BlockParseFunction)(BinaryReader& stream, BlockData& block);
+	typedef void (NifDocument::* BlockWriteFunction)(BinaryWriter& stream, BlockData& block);
 
+	// blocks are parsed in parallel, so each run of them gets its own arena. the blocks hold memory from these, they have to go last
+	std::vector<std::unique_ptr<Engine::MemoryArena>> Arenas;
+	size_t ArenaBlockSize = Engine::MemoryArena::DefaultBlockSize;
 	std::vector<std::string> BlockTypes;
 	std::vector<unsigned short> BlockTypeIndices;
 	std::vector<unsigned int> BlockSizes;
-	std::vector<std::string> Strings;
+	NifStringTable Strings;
 	std::vector<BlockData> Blocks;
 	std::map<unsigned short, BlockData> BlockMap;
 	Endian Endian;
 
-	void ParserNoOp(std::istream& stream, BlockData& block);
-	void ParseStream(std::istream& stream, BlockData& block);
-	void ParseSourceTexture(std::istream& stream, BlockData& block);
-	void ParseTexturingProperty(std::istream& stream, BlockData& block);
-	void ParseTransform(std::istream& stream, NiTransform& transform, bool translationFirst = true, bool isQuaternion = false);
-	void ParseBounds(std::istream& stream, NiBounds& bounds);
-	void ParseMesh(std::istream& stream, BlockData& block);
-	void ParseNode(std::istream& stream, BlockData& block);
-	void ParseMaterialProperty(std::istream& stream, BlockData& block);
-	void ParseSkinningMeshModifier(std::istream& stream, BlockData& block);
-	void ParseSequenceData(std::istream& stream, BlockData& block);
-	void ParseBSplineCompTransformEvaluator(std::istream& stream, BlockData& block);
-	void ParseBSpineData(std::istream& stream, BlockData& block);
-	void ParseEvaluator(std::istream& stream, BlockData& block, NiEvaluator* data);
-	void ParseBSplineBasisData(std::istream& stream, BlockData& block);
-	void ParseTransformEvaluator(std::istream& stream, BlockData& block);
-	void ParseTransformData(std::istream& stream, BlockData& block);
-	void ParseTextKeyExtraData(std::istream& stream, BlockData& block);
-
-	void WriteNode(std::ostream& stream, BlockData& block);
-	void WriteMesh(std::ostream& stream, BlockData& block);
-	void WriteVertexColorProperty(std::ostream& stream, BlockData& block);
-	void WriteZBufferProperty(std::ostream& stream, BlockData& block);
-	void WriteSpecularProperty(std::ostream& stream, BlockData& block);
-	void WriteMaterialProperty(std::ostream& stream, BlockData& block);
-	void WriteTexturingProperty(std::ostream& stream, BlockData& block);
-	void WriteSourceTexture(std::ostream& stream, BlockData& block);
-	void WriteFloatExtraData(std::ostream& stream, BlockData& block);
-	void WriteColorExtraData(std::ostream& stream, BlockData& block);
-	void WriteIntegerExtraData(std::ostream& stream, BlockData& block);
-	void WriteMorphWeightsController(std::ostream& stream, BlockData& block);
-	void WriteFloatInterpolator(std::ostream& stream, BlockData& block);
-	void WriteFloatData(std::ostream& stream, BlockData& block);
-	void WriteMorphMeshModifier(std::ostream& stream, BlockData& block);
-	void WriteDataStream(std::ostream& stream, BlockData& block);
-
-	void WriteString(std::ostream& stream, const std::string& text);
-	void WriteRef(std::ostream& stream, const BlockData* block);
-	void WriteMatrix(std::ostream& stream, const Matrix4F& block);
+	NifDocument(size_t arenaBlockSize = Engine::MemoryArena::DefaultBlockSize) : ArenaBlockSize(arenaBlockSize) {}
+
+	void Read(const char* data, size_t dataSize);
+	void ParseBlock(const char* data, unsigned int blockIndex, ::Endian endian);
+	size_t GetArenaAllocationCount() const;
+	size_t GetArenaBlockCount() const;
+
+	void ParserNoOp(BinaryReader& stream, BlockData& block);
+	void ParseStream(BinaryReader& stream, BlockData& block);
+	void ParseSourceTexture(BinaryReader& stream, BlockData& block);
+	void ParseTexturingProperty(BinaryReader& stream, BlockData& block);
+	void ParseTransform(BinaryReader& stream, NiTransform& transform, bool translationFirst = true, bool isQuaternion = false);
+	void ParseBounds(BinaryReader& stream, NiBounds& bounds);
+	void ParseMesh(BinaryReader& stream, BlockData& block);
+	void ParseNode(BinaryReader& stream, BlockData& block);
+	void ParseMaterialProperty(BinaryReader& stream, BlockData& block);
+	void ParseSkinningMeshModifier(BinaryReader& stream, BlockData& block);
+	void ParseSequenceData(BinaryReader& stream, BlockData& block);
+	void ParseBSplineCompTransformEvaluator(BinaryReader& stream, BlockData& block);
+	void ParseBSpineData(BinaryReader& stream, BlockData& block);
+	void ParseEvaluator(BinaryReader& stream, BlockData& block, NiEvaluator* data);
+	void ParseBSplineBasisData(BinaryReader& stream, BlockData& block);
+	void ParseTransformEvaluator(BinaryReader& stream, BlockData& block);
+	void ParseTransformData(BinaryReader& stream, BlockData& block);
+	void ParseTextKeyExtraData(BinaryReader& stream, BlockData& block);
+
+	void WriteNode(BinaryWriter& stream, BlockData& block);
+	void WriteMesh(BinaryWriter& stream, BlockData& block);
+	void WriteVertexColorProperty(BinaryWriter& stream, BlockData& block);
+	void WriteZBufferProperty(BinaryWriter& stream, BlockData& block);
+	void WriteSpecularProperty(BinaryWriter& stream, BlockData& block);
+	void WriteMaterialProperty(BinaryWriter& stream, BlockData& block);
+	void WriteTexturingProperty(BinaryWriter& stream, BlockData& block);
+	void WriteSourceTexture(BinaryWriter& stream, BlockData& block);
+	void WriteFloatExtraData(BinaryWriter& stream, BlockData& block);
+	void WriteColorExtraData(BinaryWriter& stream, BlockData& block);
+	void WriteIntegerExtraData(BinaryWriter& stream, BlockData& block);
+	void WriteMorphWeightsController(BinaryWriter& stream, BlockData& block);
+	void WriteFloatInterpolator(BinaryWriter& stream, BlockData& block);
+	void WriteFloatData(BinaryWriter& stream, BlockData& block);
+	void WriteMorphMeshModifier(BinaryWriter& stream, BlockData& block);
+	void WriteDataStream(BinaryWriter& stream, BlockData& block);
+
+	void WriteString(BinaryWriter& stream, const std::string& text);
+	void WriteRef(BinaryWriter& stream, const BlockData* block);
+	void WriteMatrix(BinaryWriter& stream, const Matrix4F& block);
 
 	template <typename T>
 	BlockData* MakeExtraData(const std::string& name, const typename T::ValueType& value)
@@ -765,48 +811,48 @@ struct NifDocument
 	BlockData& MakeBlock(const std::string& name);
 	BlockData& InitializeBlock(unsigned int blockIndex);
 	const BlockData* FetchRef(unsigned int ref);
-	const BlockData* FetchRef(std::istream& stream);
+	const BlockData* FetchRef(BinaryReader& stream);
 	const std::string& FetchString(unsigned int ref);
-	const std::string& FetchString(std::istream& stream);
-	void ReadBlockRefs(std::istream& stream, BlockData& block, std::vector<const BlockData*>& refs);
+	const std::string& FetchString(BinaryReader& stream);
+	void ReadBlockRefs(BinaryReader& stream, BlockData& block, NifArray<const BlockData*>& refs);
 };
 
 std::shared_ptr<Engine::Graphics::MeshFormat> GetNiMeshFormat();
 
 template <typename KeyType>
-void LinearKey<KeyType>::Parse(NifDocument* document, std::istream& stream)
+void LinearKey<KeyType>::Parse(NifDocument* document, BinaryReader& stream)
 {
-	Time = document->Endian.read<float>(stream);
+	Time = stream.read<float>();
 	Value = ParseKey<KeyType>(document, stream);
 }
 
 template <typename KeyType>
-void QuadraticKey<KeyType>::Parse(NifDocument* document, std::istream& stream)
+void QuadraticKey<KeyType>::Parse(NifDocument* document, BinaryReader& stream)
 {
-	Time = document->Endian.read<float>(stream);
+	Time = stream.read<float>();
 	Value = ParseKey<KeyType>(document, stream);
 	Forward = ParseKey<KeyType>(document, stream);
 	Backward = ParseKey<KeyType>(document, stream);
 }
 
 template <typename KeyType>
-void TbcKey<KeyType>::Parse(NifDocument* document, std::istream& stream)
+void TbcKey<KeyType>::Parse(NifDocument* document, BinaryReader& stream)
 {
-	Time = document->Endian.read<float>(stream);
+	Time = stream.read<float>();
 	Value = ParseKey<KeyType>(document, stream);
-	Tension = document->Endian.read<float>(stream);
-	Bias = document->Endian.read<float>(stream);
-	Continuity = document->Endian.read<float>(stream);
+	Tension = stream.read<float>();
+	Bias = stream.read<float>();
+	Continuity = stream.read<float>();
 }
 
 template <typename KeyType>
-void Keys<KeyType>::Parse(NifDocument* document, std::istream& stream)
+void Keys<KeyType>::Parse(NifDocument* document, BinaryReader& stream)
 {
-	unsigned int length = document->Endian.read<unsigned int>(stream);
+	unsigned int length = stream.read<unsigned int>();
 
 	if (length == 0) return;
 
-	Interpolation = (RotationType)document->Endian.read<unsigned int>(stream);
+	Interpolation = (RotationType)stream.read<unsigned int>();
 
 	if (Interpolation != KeyType::Type)
 		throw "unsupported";
@@ -819,7 +865,7 @@ void Keys<KeyType>::Parse(NifDocument* document, std::istream& stream)
 
 template <typename KeyType>
 template <typename Vector>
-void AnyKeys<KeyType>::ParseKeyVector(NifDocument* document, std::istream& stream, Vector& vector, unsigned int keys)
+void AnyKeys<KeyType>::ParseKeyVector(NifDocument* document, BinaryReader& stream, Vector& vector, unsigned int keys)
 {
 	vector.resize(keys);
 
@@ -840,13 +886,13 @@ constexpr bool IsQuaternion<Quaternion>()
 }
 
 template <typename KeyType>
-void AnyKeys<KeyType>::Parse(NifDocument* document, std::istream& stream)
+void AnyKeys<KeyType>::Parse(NifDocument* document, BinaryReader& stream)
 {
-	unsigned int length = document->Endian.read<unsigned int>(stream);
+	unsigned int length = stream.read<unsigned int>();
 
 	if (length == 0) return;
 
-	Interpolation = (RotationType)document->Endian.read<unsigned int>(stream);
+	Interpolation = (RotationType)stream.read<unsigned int>();
 
 	if (Interpolation == RotationType::ConstKey)
 		throw "unsupported";
@@ -872,7 +918,7 @@ void AnyKeys<KeyType>::Parse(NifDocument* document, std::istream& stream)
 
 template <typename KeyType>
 template <typename Vector>
-void AnyKeysNoRotate<KeyType>::ParseKeyVector(NifDocument* document, std::istream& stream, Vector& vector, unsigned int keys)
+void AnyKeysNoRotate<KeyType>::ParseKeyVector(NifDocument* document, BinaryReader& stream, Vector& vector, unsigned int keys)
 {
 	vector.resize(keys);
 
@@ -881,13 +927,13 @@ void AnyKeysNoRotate<KeyType>::ParseKeyVector(NifDocument* document, std::istrea
 }
 
 template <typename KeyType>
-void AnyKeysNoRotate<KeyType>::Parse(NifDocument* document, std::istream& stream)
+void AnyKeysNoRotate<KeyType>::Parse(NifDocument* document, BinaryReader& stream)
 {
-	unsigned int length = document->Endian.read<unsigned int>(stream);
+	unsigned int length = stream.read<unsigned int>();
 
 	if (length == 0) return;
 
-	Interpolation = (RotationType)document->Endian.read<unsigned int>(stream);
+	Interpolation = (RotationType)stream.read<unsigned int>();
 
 	if (Interpolation == RotationType::ConstKey || Interpolation == RotationType::XyzRotationKey)
 		throw "unsupported";
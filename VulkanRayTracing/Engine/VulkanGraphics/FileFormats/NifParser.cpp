@@ -4,26 +4,29 @@ import <string>;
 import <vector>;
 import <map>;
 import <set>;
+import <cstring>;
+import <algorithm>;
 
 #include <Engine/Math/Vector3S.h>
 #include <Engine/Math/Vector2S.h>
 #include <Engine/Math/Matrix4.h>
 #include <Engine/Math/Quaternion.h>
-#include <Engine/Assets/ParserUtils.h>
+#include <Engine/Assets/BinaryReader.h>
 #include <Engine/Objects/Transform.h>
+#include <Engine/ThreadPool.h>
 
 #include <Engine/VulkanGraphics/Scene/MeshData.h>
 #include "NifComponentInfo.h"
 #include "NifBlockTypes.h"
 
-void NifDocument::ParseTransform(std::istream& stream, NiTransform& transform, bool translationFirst, bool isQuaternion)
+void NifDocument::ParseTransform(BinaryReader& stream, NiTransform& transform, bool translationFirst, bool isQuaternion)
 {
 	if (translationFirst)
 	{
 		transform.Translation = Vector3SF(
-			Endian.read<float>(stream),
-			Endian.read<float>(stream),
-			Endian.read<float>(stream)
+			stream.read<float>(),
+			stream.read<float>(),
+			stream.read<float>()
 		);
 	}
 
@@ -32,175 +35,140 @@ void NifDocument::ParseTransform(std::istream& stream, NiTransform& transform, b
 		transform.Rotation = Matrix4F(
 			Vector3F(),
 			Vector3F(
-				Endian.read<float>(stream),
-				Endian.read<float>(stream),
-				Endian.read<float>(stream)
+				stream.read<float>(),
+				stream.read<float>(),
+				stream.read<float>()
 			),
 			Vector3F(
-				Endian.read<float>(stream),
-				Endian.read<float>(stream),
-				Endian.read<float>(stream)
+				stream.read<float>(),
+				stream.read<float>(),
+				stream.read<float>()
 			),
 			Vector3F(
-				Endian.read<float>(stream),
-				Endian.read<float>(stream),
-				Endian.read<float>(stream)
+				stream.read<float>(),
+				stream.read<float>(),
+				stream.read<float>()
 			)
 		);
 	}
 	else
 	{
 		transform.Rotation = Quaternion(Vector3(
-			Endian.read<float>(stream),
-			Endian.read<float>(stream),
-			Endian.read<float>(stream),
-			Endian.read<float>(stream)
+			stream.read<float>(),
+			stream.read<float>(),
+			stream.read<float>(),
+			stream.read<float>()
 		)).MatrixF();
 	}
 
 	if (!translationFirst)
 	{
 		transform.Translation = Vector3SF(
-			Endian.read<float>(stream),
-			Endian.read<float>(stream),
-			Endian.read<float>(stream)
+			stream.read<float>(),
+			stream.read<float>(),
+			stream.read<float>()
 		);
 	}
 
 	std::swap(transform.Translation.X, transform.Translation.Z);
 
-	transform.Scale = Endian.read<float>(stream);
+	transform.Scale = stream.read<float>();
 }
 
-void NifDocument::ParseBounds(std::istream& stream, NiBounds& bounds)
+void NifDocument::ParseBounds(BinaryReader& stream, NiBounds& bounds)
 {
 	bounds.Center = Vector3SF(
-		Endian.read<float>(stream),
-		Endian.read<float>(stream),
-		Endian.read<float>(stream)
+		stream.read<float>(),
+		stream.read<float>(),
+		stream.read<float>()
 	);
-	bounds.Radius = Endian.read<float>(stream);
+	bounds.Radius = stream.read<float>();
 
 	std::swap(bounds.Center.X, bounds.Center.Z);
 }
 
-void NifDocument::ParseNode(std::istream& stream, BlockData& block)
+void NifDocument::ParseNode(BinaryReader& stream, BlockData& block)
 {
 	NiNode* data = block.AddData<NiNode>();
 
-	unsigned int numExtraData = Endian.read<unsigned int>(stream);
-
-	data->ExtraData.resize(numExtraData);
-
-	for (unsigned int i = 0; i < numExtraData; ++i)
-		data->ExtraData[i] = &Blocks[Endian.read<unsigned int>(stream)];
+	ReadBlockRefs(stream, block, data->ExtraData);
 
 	data->Controller = FetchRef(stream);
-	data->Flags = Endian.read<unsigned short>(stream);
+	data->Flags = stream.read<unsigned short>();
 	
 	ParseTransform(stream, data->Transformation);
 
-	unsigned int numProperties = Endian.read<unsigned int>(stream);
-
-	data->Properties.resize(numProperties);
-
-	for (unsigned int i = 0; i < numProperties; ++i)
-		data->Properties[i] = &Blocks[Endian.read<unsigned int>(stream)];
+	ReadBlockRefs(stream, block, data->Properties);
 
 	data->CollisionObject = FetchRef(stream);
 
-	unsigned int numChildren = Endian.read<unsigned int>(stream);
-
-	data->Children.resize(numChildren);
-
-	for (unsigned int i = 0; i < numChildren; ++i)
-	{
-		unsigned int childIndex = Endian.read<unsigned int>(stream);
-
-		if (childIndex != (unsigned int)-1)
-			data->Children[i] = &Blocks[childIndex];
-	}
-
-	unsigned int numEffects = Endian.read<unsigned int>(stream);
-
-	data->Effects.resize(numEffects);
+	ReadBlockRefs(stream, block, data->Children);
 
-	for (unsigned int i = 0; i < numEffects; ++i)
-		data->Effects[i] = &Blocks[Endian.read<unsigned int>(stream)];
+	ReadBlockRefs(stream, block, data->Effects);
 }
 
-void NifDocument::ParseMesh(std::istream& stream, BlockData& block)
+void NifDocument::ParseMesh(BinaryReader& stream, BlockData& block)
 {
 	NiMesh* data = block.AddData<NiMesh>();
 
-	unsigned int numExtraData = Endian.read<unsigned int>(stream);
-
-	data->ExtraData.resize(numExtraData);
-
-	for (unsigned int i = 0; i < numExtraData; ++i)
-		data->ExtraData[i] = &Blocks[Endian.read<unsigned int>(stream)];
+	ReadBlockRefs(stream, block, data->ExtraData);
 
 	data->Controller = FetchRef(stream);
-	data->Flags = Endian.read<unsigned short>(stream);
+	data->Flags = stream.read<unsigned short>();
 
 	ParseTransform(stream, data->Transformation);
 
-	unsigned int numProperties = Endian.read<unsigned int>(stream);
-
-	data->Properties.resize(numProperties);
-
-	for (unsigned int i = 0; i < numProperties; ++i)
-		data->Properties[i] = &Blocks[Endian.read<unsigned int>(stream)];
+	ReadBlockRefs(stream, block, data->Properties);
 
 	data->CollisionObject = FetchRef(stream);
 
-	unsigned int numMaterials = Endian.read<unsigned int>(stream);
+	unsigned int numMaterials = stream.read<unsigned int>();
 
 	data->Materials.resize(numMaterials);
 	data->MaterialExtraData.resize(numMaterials);
 
 	for (unsigned int i = 0; i < numMaterials; ++i)
-		data->Materials[i] = Strings[Endian.read<unsigned int>(stream)];
+		data->Materials[i] = FetchString(stream);
 
 	for (unsigned int i = 0; i < numMaterials; ++i)
 		data->MaterialExtraData[i] = FetchRef(stream);
 
-	data->ActiveMaterial = Endian.read<unsigned int>(stream);
-	data->MaterialNeedsUpdate = Endian.read<char>(stream);
-	data->PrimitiveType = (MeshPrimitiveType)Endian.read<unsigned int>(stream);
-	data->NumSubmeshes = Endian.read<unsigned short>(stream);
-	data->InstancingEnabled = Endian.read<char>(stream);
+	data->ActiveMaterial = stream.read<unsigned int>();
+	data->MaterialNeedsUpdate = stream.read<char>();
+	data->PrimitiveType = (MeshPrimitiveType)stream.read<unsigned int>();
+	data->NumSubmeshes = stream.read<unsigned short>();
+	data->InstancingEnabled = stream.read<char>();
 
 	ParseBounds(stream, data->Bounds);
 
-	unsigned int numDataStreams = Endian.read<unsigned int>(stream);
+	unsigned int numDataStreams = stream.read<unsigned int>();
 
 	data->Streams.resize(numDataStreams);
 
 	for (unsigned int i = 0; i < numDataStreams; ++i)
 	{
 		data->Streams[i].Stream = FetchRef(stream);
-		data->Streams[i].IsPerInstance = Endian.read<char>(stream);
+		data->Streams[i].IsPerInstance = stream.read<char>();
 		
-		unsigned short numSubMeshes = Endian.read<unsigned short>(stream);
+		unsigned short numSubMeshes = stream.read<unsigned short>();
 
 		data->Streams[i].SubmeshToRegionMap.resize(numSubMeshes);
 
 		for (unsigned short j = 0; j < numSubMeshes; ++j)
-			data->Streams[i].SubmeshToRegionMap[j] = Endian.read<unsigned short>(stream);
+			data->Streams[i].SubmeshToRegionMap[j] = stream.read<unsigned short>();
 
-		unsigned int numSemantics = Endian.read<unsigned int>(stream);
+		unsigned int numSemantics = stream.read<unsigned int>();
 
 		data->Streams[i].ComponentSemantics.resize(numSemantics);
 
 		for (unsigned int j = 0; j < numSemantics; ++j)
 		{
-			data->Streams[i].ComponentSemantics[j].Name = Strings[Endian.read<unsigned int>(stream)];
-			data->Streams[i].ComponentSemantics[j].Index = Endian.read<unsigned int>(stream);
+			data->Streams[i].ComponentSemantics[j].Name = FetchString(stream);
+			data->Streams[i].ComponentSemantics[j].Index = stream.read<unsigned int>();
 		}
 	}
 
-	unsigned int numModifiers = Endian.read<unsigned int>(stream);
+	unsigned int numModifiers = stream.read<unsigned int>();
 
 	data->Modifiers.resize(numModifiers);
 
@@ -208,36 +176,36 @@ void NifDocument::ParseMesh(std::istream& stream, BlockData& block)
 		data->Modifiers[i] = FetchRef(stream);
 }
 
-void NifDocument::ParseTexturingProperty(std::istream& stream, BlockData& block)
+void NifDocument::ParseTexturingProperty(BinaryReader& stream, BlockData& block)
 {
 	NiTexturingProperty* data = block.AddData<NiTexturingProperty>();
 
 	auto readTextureData = [&](NiTexturingProperty::TextureData& data)
 	{
-		data.HasThisTexture = Endian.read<char>(stream);
+		data.HasThisTexture = stream.read<char>();
 
 		if (!data.HasThisTexture) return;
 
 		data.Source = FetchRef(stream);
-		data.Flags = Endian.read<unsigned short>(stream);
-		data.MaxAnisotropy = Endian.read<unsigned short>(stream);
-		data.HasTextureTransform = Endian.read<char>(stream);
+		data.Flags = stream.read<unsigned short>();
+		data.MaxAnisotropy = stream.read<unsigned short>();
+		data.HasTextureTransform = stream.read<char>();
 
 		if (data.HasTextureTransform)
 		{
-			data.Translation.Set(Endian.read<float>(stream), Endian.read<float>(stream));
-			data.Scale.Set(Endian.read<float>(stream), Endian.read<float>(stream));
-			data.Rotation = Endian.read<float>(stream);
-			data.TransformMethod = Endian.read<unsigned int>(stream);
-			data.Center.Set(Endian.read<float>(stream), Endian.read<float>(stream));
+			data.Translation.Set(stream.read<float>(), stream.read<float>());
+			data.Scale.Set(stream.read<float>(), stream.read<float>());
+			data.Rotation = stream.read<float>();
+			data.TransformMethod = stream.read<unsigned int>();
+			data.Center.Set(stream.read<float>(), stream.read<float>());
 		}
 	};
 
 	ReadBlockRefs(stream, block, data->ExtraData);
 
 	data->Controller = FetchRef(stream);
-	data->Flags = Endian.read<unsigned short>(stream);
-	data->TextureCount = Endian.read<unsigned int>(stream);
+	data->Flags = stream.read<unsigned short>();
+	data->TextureCount = stream.read<unsigned int>();
 
 	readTextureData(data->BaseTexture);
 	readTextureData(data->DarkTexture);
@@ -248,15 +216,15 @@ void NifDocument::ParseTexturingProperty(std::istream& stream, BlockData& block)
 
 	if (data->BumpTexture.HasThisTexture)
 	{
-		data->BumpMapLumaScale = Endian.read<float>(stream);
-		data->BumpMapLumaOffset = Endian.read<float>(stream);
+		data->BumpMapLumaScale = stream.read<float>();
+		data->BumpMapLumaOffset = stream.read<float>();
 		data->BumpMapRight.Set(
-			Endian.read<float>(stream),
-			Endian.read<float>(stream)
+			stream.read<float>(),
+			stream.read<float>()
 		);
 		data->BumpMapUp.Set(
-			Endian.read<float>(stream),
-			Endian.read<float>(stream)
+			stream.read<float>(),
+			stream.read<float>()
 		);
 	}
 
@@ -264,7 +232,7 @@ void NifDocument::ParseTexturingProperty(std::istream& stream, BlockData& block)
 	readTextureData(data->ParallaxTexture);
 	readTextureData(data->Decal0Texture);
 
-	unsigned int shaderTextureCount = Endian.read<unsigned int>(stream);
+	unsigned int shaderTextureCount = stream.read<unsigned int>();
 
 	data->ShaderTextures.resize(shaderTextureCount);
 
@@ -273,59 +241,56 @@ void NifDocument::ParseTexturingProperty(std::istream& stream, BlockData& block)
 		readTextureData(data->ShaderTextures[i].Map);
 
 		if (data->ShaderTextures[i].Map.HasThisTexture)
-			data->ShaderTextures[i].MapId = Endian.read<unsigned int>(stream);
+			data->ShaderTextures[i].MapId = stream.read<unsigned int>();
 	}
 }
 
-void NifDocument::ParseSourceTexture(std::istream& stream, BlockData& block)
+void NifDocument::ParseSourceTexture(BinaryReader& stream, BlockData& block)
 {
 	NiSourceTexture* data = block.AddData<NiSourceTexture>();
 
 	ReadBlockRefs(stream, block, data->ExtraData);
 
 	data->Controller = FetchRef(stream);
-	data->UseExternal = Endian.read<unsigned char>(stream);
+	data->UseExternal = stream.read<unsigned char>();
 	
-	unsigned int name = Endian.read<unsigned int>(stream);
-
-	if (name != 0xFFFFFFFFu)
-		data->FileName = Strings[name];
+	data->FileName = FetchString(stream);
 
 	data->PixelData = FetchRef(stream);
-	data->PixelLayout = Endian.read<unsigned int>(stream);
-	data->UseMipmaps = Endian.read<unsigned int>(stream);
-	data->AlphaFormat = Endian.read<unsigned int>(stream);
-	data->IsStatic = Endian.read<unsigned char>(stream);
-	data->DirectRender = Endian.read<unsigned char>(stream);
-	data->PersistRenderData = Endian.read<unsigned char>(stream);
+	data->PixelLayout = stream.read<unsigned int>();
+	data->UseMipmaps = stream.read<unsigned int>();
+	data->AlphaFormat = stream.read<unsigned int>();
+	data->IsStatic = stream.read<unsigned char>();
+	data->DirectRender = stream.read<unsigned char>();
+	data->PersistRenderData = stream.read<unsigned char>();
 }
 
-void NifDocument::ParseStream(std::istream& stream, BlockData& block)
+void NifDocument::ParseStream(BinaryReader& stream, BlockData& block)
 {
 	NiDataStream* data = block.AddData<NiDataStream>();
 
 	data->Usage = (StreamUsage)(block.BlockType[13] - '0'); // they embedded both Usage and Access in the name, ew
-	data->StreamSize = Endian.read<unsigned int>(stream);
-	data->CloningBehavior = (CloningBehavior)Endian.read<unsigned int>(stream);
+	data->StreamSize = stream.read<unsigned int>();
+	data->CloningBehavior = (CloningBehavior)stream.read<unsigned int>();
 
-	unsigned int numRegions = Endian.read<unsigned int>(stream);
+	unsigned int numRegions = stream.read<unsigned int>();
 
 	data->Regions.resize(numRegions);
 
 	for (unsigned int i = 0; i < numRegions; ++i)
 	{
-		data->Regions[i].StartIndex = Endian.read<unsigned int>(stream);
-		data->Regions[i].NumIndices = Endian.read<unsigned int>(stream);
+		data->Regions[i].StartIndex = stream.read<unsigned int>();
+		data->Regions[i].NumIndices = stream.read<unsigned int>();
 	}
 
-	unsigned int numComponents = Endian.read<unsigned int>(stream);
+	unsigned int numComponents = stream.read<unsigned int>();
 
 	data->ComponentFormats.resize(numComponents);
 	data->Attributes.resize(numComponents);
 
 	for (unsigned int i = 0; i < numComponents; ++i)
 	{
-		data->ComponentFormats[i] = (ComponentFormat)Endian.read<unsigned int>(stream);
+		data->ComponentFormats[i] = (ComponentFormat)stream.read<unsigned int>();
 
 		auto index = ComponentInfo.find(data->ComponentFormats[i]);
 
@@ -341,48 +306,56 @@ void NifDocument::ParseStream(std::istream& stream, BlockData& block)
 		}
 	}
 
-	data->StreamData.resize(data->StreamSize);
+	// the payload is left where it is in the buffer being parsed instead of being copied out
+	data->StreamView = stream.readSpan(data->StreamSize);
 
-	stream.read(data->StreamData.data(), data->StreamSize);
-
-	data->Streamable = Endian.read<char>(stream);
+	data->Streamable = stream.read<char>();
 }
 
-void NifDocument::ParseMaterialProperty(std::istream& stream, BlockData& block)
+void NifDocument::ParseMaterialProperty(BinaryReader& stream, BlockData& block)
 {
 	NiMaterialProperty* data = block.AddData<NiMaterialProperty>();
 
 	ReadBlockRefs(stream, block, data->ExtraData);
 
 	data->Controller = FetchRef(stream);
-	data->AmbientColor = Endian.read<Color3>(stream);
-	data->DiffuseColor = Endian.read<Color3>(stream);
-	data->SpecularColor = Endian.read<Color3>(stream);
-	data->EmissiveColor = Endian.read<Color3>(stream);
-	data->Glossiness = Endian.read<float>(stream);
-	data->Alpha = Endian.read<float>(stream);
+	auto readColor = [&stream]()
+	{
+		float color[3] = {};
+
+		stream.readArray(color, 3);
+
+		return Color3(color[0], color[1], color[2]);
+	};
+
+	data->AmbientColor = readColor();
+	data->DiffuseColor = readColor();
+	data->SpecularColor = readColor();
+	data->EmissiveColor = readColor();
+	data->Glossiness = stream.read<float>();
+	data->Alpha = stream.read<float>();
 }
 
-void NifDocument::ParseSkinningMeshModifier(std::istream& stream, BlockData& block)
+void NifDocument::ParseSkinningMeshModifier(BinaryReader& stream, BlockData& block)
 {
 	NiSkinningMeshModifier* data = block.AddData<NiSkinningMeshModifier>();
 
-	unsigned int numSubmitPoints = Endian.read<unsigned int>(stream);
+	unsigned int numSubmitPoints = stream.read<unsigned int>();
 
-	for (unsigned int i = 0; i < numSubmitPoints; ++i)
-		data->SubmitPoints.push_back(Endian.read<unsigned short>(stream));
+	data->SubmitPoints.resize(numSubmitPoints);
+	stream.readArray(data->SubmitPoints.data(), numSubmitPoints);
 
-	unsigned int numCompletePoints = Endian.read<unsigned int>(stream);
+	unsigned int numCompletePoints = stream.read<unsigned int>();
 
-	for (unsigned int i = 0; i < numCompletePoints; ++i)
-		data->CompletePoints.push_back(Endian.read<unsigned short>(stream));
+	data->CompletePoints.resize(numCompletePoints);
+	stream.readArray(data->CompletePoints.data(), numCompletePoints);
 
-	data->Flags = Endian.read<unsigned short>(stream);
+	data->Flags = stream.read<unsigned short>();
 	data->SkeletonRoot = FetchRef(stream);
 
 	ParseTransform(stream, data->SkeletonTransformation, false);
 
-	unsigned int numBones = Endian.read<unsigned int>(stream);
+	unsigned int numBones = stream.read<unsigned int>();
 
 	for (unsigned int i = 0; i < numBones; ++i)
 		data->Bones.push_back(FetchRef(stream));
@@ -402,11 +375,11 @@ void NifDocument::ParseSkinningMeshModifier(std::istream& stream, BlockData& blo
 	}
 }
 
-void NifDocument::ParseSequenceData(std::istream& stream, BlockData& block)
+void NifDocument::ParseSequenceData(BinaryReader& stream, BlockData& block)
 {
 	NiSequenceData* data = block.AddData<NiSequenceData>();
 
-	unsigned int numEvaluators = Endian.read<unsigned int>(stream);
+	unsigned int numEvaluators = stream.read<unsigned int>();
 
 	data->Evaluators.resize(numEvaluators);
 
@@ -414,19 +387,16 @@ void NifDocument::ParseSequenceData(std::istream& stream, BlockData& block)
 		data->Evaluators[i] = FetchRef(stream);
 
 	data->TextKeys = FetchRef(stream);
-	data->Duration = Endian.read<float>(stream);
-	data->CycleType = (CycleType)Endian.read<unsigned int>(stream);
-	data->Frequency = Endian.read<float>(stream);
+	data->Duration = stream.read<float>();
+	data->CycleType = (CycleType)stream.read<unsigned int>();
+	data->Frequency = stream.read<float>();
 
-	unsigned int name = Endian.read<unsigned int>(stream);
+	data->AccumRootName = FetchString(stream);
 
-	if (name != 0xFFFFFFFFu)
-		data->AccumRootName = Strings[name];
-
-	data->AccumFlags = (AccumFlags)Endian.read<unsigned int>(stream);
+	data->AccumFlags = (AccumFlags)stream.read<unsigned int>();
 }
 
-void NifDocument::ParseEvaluator(std::istream& stream, BlockData& block, NiEvaluator* data)
+void NifDocument::ParseEvaluator(BinaryReader& stream, BlockData& block, NiEvaluator* data)
 {
 	data->NodeName = FetchString(stream);
 	data->PropertyType = FetchString(stream);
@@ -434,10 +404,10 @@ void NifDocument::ParseEvaluator(std::istream& stream, BlockData& block, NiEvalu
 	data->ControllerId = FetchString(stream);
 	data->InterpolatorId = FetchString(stream);
 	
-	unsigned char positionChannel = Endian.read<unsigned char>(stream);
-	unsigned char rotationChannel = Endian.read<unsigned char>(stream);
-	unsigned char scaleChannel = Endian.read<unsigned char>(stream);
-	unsigned char flags = Endian.read<unsigned char>(stream);
+	unsigned char positionChannel = stream.read<unsigned char>();
+	unsigned char rotationChannel = stream.read<unsigned char>();
+	unsigned char scaleChannel = stream.read<unsigned char>();
+	unsigned char flags = stream.read<unsigned char>();
 
 	data->PositionPosed = positionChannel & 0x40;
 	data->PositionChannel = (ChannelType)(positionChannel & 0x2F);
@@ -449,57 +419,53 @@ void NifDocument::ParseEvaluator(std::istream& stream, BlockData& block, NiEvalu
 	data->ChannelFlags = (ChannelTypeFlags)flags;
 }
 
-void NifDocument::ParseBSplineCompTransformEvaluator(std::istream& stream, BlockData& block)
+void NifDocument::ParseBSplineCompTransformEvaluator(BinaryReader& stream, BlockData& block)
 {
 	NiBSplineCompTransformEvaluator* data = block.AddData<NiBSplineCompTransformEvaluator>();
 
 	ParseEvaluator(stream, block, data);
 
-	data->StartTime = Endian.read<float>(stream);
-	data->EndTime = Endian.read<float>(stream);
+	data->StartTime = stream.read<float>();
+	data->EndTime = stream.read<float>();
 	data->Data = FetchRef(stream);
 	data->BasisData = FetchRef(stream);
 
 	ParseTransform(stream, data->Transform, true, true);
 
-	data->TranslationHandle = Endian.read<unsigned int>(stream);
-	data->RotationHandle = Endian.read<unsigned int>(stream);
-	data->ScaleHandle = Endian.read<unsigned int>(stream);
-	data->TranslationOffset = Endian.read<float>(stream);
-	data->TranslationHalfRange = Endian.read<float>(stream);
-	data->RotationOffset = Endian.read<float>(stream);
-	data->RotationHalfRange = Endian.read<float>(stream);
-	data->ScaleOffset = Endian.read<float>(stream);
-	data->ScaleHalfRange = Endian.read<float>(stream);
+	data->TranslationHandle = stream.read<unsigned int>();
+	data->RotationHandle = stream.read<unsigned int>();
+	data->ScaleHandle = stream.read<unsigned int>();
+	data->TranslationOffset = stream.read<float>();
+	data->TranslationHalfRange = stream.read<float>();
+	data->RotationOffset = stream.read<float>();
+	data->RotationHalfRange = stream.read<float>();
+	data->ScaleOffset = stream.read<float>();
+	data->ScaleHalfRange = stream.read<float>();
 }
 
-void NifDocument::ParseBSpineData(std::istream& stream, BlockData& block)
+void NifDocument::ParseBSpineData(BinaryReader& stream, BlockData& block)
 {
 	NiBSpineData* data = block.AddData<NiBSpineData>();
 
-	unsigned int numFloatControlPoints = Endian.read<unsigned int>(stream);
+	unsigned int numFloatControlPoints = stream.read<unsigned int>();
 
 	data->FloatControlPoints.resize(numFloatControlPoints);
+	stream.readArray(data->FloatControlPoints.data(), numFloatControlPoints);
 
-	for (unsigned int i = 0; i < numFloatControlPoints; ++i)
-		data->FloatControlPoints[i] = Endian.read<float>(stream);
-
-	unsigned int numCompactControlPoints = Endian.read<unsigned int>(stream);
+	unsigned int numCompactControlPoints = stream.read<unsigned int>();
 
 	data->CompactControlPoints.resize(numCompactControlPoints);
-
-	for (unsigned int i = 0; i < numCompactControlPoints; ++i)
-		data->CompactControlPoints[i] = Endian.read<short>(stream);
+	stream.readArray(data->CompactControlPoints.data(), numCompactControlPoints);
 }
 
-void NifDocument::ParseBSplineBasisData(std::istream& stream, BlockData& block)
+void NifDocument::ParseBSplineBasisData(BinaryReader& stream, BlockData& block)
 {
 	NiBSplineBasisData* data = block.AddData<NiBSplineBasisData>();
 
-	data->NumControlPoints = Endian.read<unsigned int>(stream);
+	data->NumControlPoints = stream.read<unsigned int>();
 }
 
-void NifDocument::ParseTransformEvaluator(std::istream& stream, BlockData& block)
+void NifDocument::ParseTransformEvaluator(BinaryReader& stream, BlockData& block)
 {
 	NiTransformEvaluator* data = block.AddData<NiTransformEvaluator>();
 
@@ -510,34 +476,34 @@ void NifDocument::ParseTransformEvaluator(std::istream& stream, BlockData& block
 }
 
 template <>
-float ParseKey<float>(NifDocument* document, std::istream& stream)
+float ParseKey<float>(NifDocument* document, BinaryReader& stream)
 {
-	return document->Endian.read<float>(stream);
+	return stream.read<float>();
 }
 
 template <>
-Quaternion ParseKey<Quaternion>(NifDocument* document, std::istream& stream)
+Quaternion ParseKey<Quaternion>(NifDocument* document, BinaryReader& stream)
 {
 	return Quaternion(Vector3(
-		document->Endian.read<float>(stream),
-		document->Endian.read<float>(stream),
-		document->Endian.read<float>(stream),
-		document->Endian.read<float>(stream)
+		stream.read<float>(),
+		stream.read<float>(),
+		stream.read<float>(),
+		stream.read<float>()
 	));
 }
 
 template <>
-Vector3F ParseKey<Vector3F>(NifDocument* document, std::istream& stream)
+Vector3F ParseKey<Vector3F>(NifDocument* document, BinaryReader& stream)
 {
 	return Vector3F(
-		document->Endian.read<float>(stream),
-		document->Endian.read<float>(stream),
-		document->Endian.read<float>(stream)
+		stream.read<float>(),
+		stream.read<float>(),
+		stream.read<float>()
 	);
 }
 
 
-void NifDocument::ParseTransformData(std::istream& stream, BlockData& block)
+void NifDocument::ParseTransformData(BinaryReader& stream, BlockData& block)
 {
 	NiTransformData* data = block.AddData<NiTransformData>();
 
@@ -546,33 +512,24 @@ void NifDocument::ParseTransformData(std::istream& stream, BlockData& block)
 	data->ScaleKeys.Parse(this, stream);
 }
 
-void NifDocument::ParseTextKeyExtraData(std::istream& stream, BlockData& block)
+void NifDocument::ParseTextKeyExtraData(BinaryReader& stream, BlockData& block)
 {
 	NiTextKeyExtraData* data = block.AddData<NiTextKeyExtraData>();
 
-	unsigned int length = Endian.read<unsigned int>(stream);
+	unsigned int length = stream.read<unsigned int>();
 
 	data->TextKeys.resize(length);
 
 	for (unsigned int i = 0; i < length; ++i)
 	{
-		data->TextKeys[i].Time = Endian.read<float>(stream);
+		data->TextKeys[i].Time = stream.read<float>();
 		data->TextKeys[i].Value = FetchString(stream);
 	}
 }
 
-void NifDocument::ParserNoOp(std::istream& stream, BlockData& block)
+void NifDocument::ParserNoOp(BinaryReader& stream, BlockData& block)
 {
-	char buffer[0xFFF];
-
-	for (unsigned int i = block.BlockStart; i < block.BlockSize;)
-	{
-		unsigned int amount = std::min(block.BlockSize - i, 0xFFFu);
-
-		stream.read(buffer, amount);
-
-		i += amount;
-	}
+	stream.skip(block.BlockSize - block.BlockStart);
 }
 
 std::map<std::string, NifDocument::BlockParseFunction> parserFunctions = {
@@ -622,142 +579,193 @@ using namespace Engine::Graphics;
 
 void NifParser::Parse(std::istream& stream)
 {
-	NifDocument document;
+	std::shared_ptr<std::vector<char>> buffer = std::make_shared<std::vector<char>>();
 
-	std::string headerString;
+	stream.seekg(0, std::ios::end);
 
-	const unsigned int bufferSize = 0xFFF;
-	char buffer[bufferSize] = {};
-	size_t size = 0;
-	size_t index = 0;
+	std::streamoff size = stream.tellg();
 
-	while (buffer[index] != 0x0A)
+	stream.seekg(0, std::ios::beg);
+
+	if (size > 0)
 	{
-		char next;
-		stream.get(next);
-		buffer[size] = next;
-		++size;
-		index = size - 1;
+		buffer->resize((size_t)size);
+		stream.read(buffer->data(), size);
+		buffer->resize((size_t)stream.gcount());
 	}
 
-	headerString.append(buffer, size - 1);
+	// the meshes can keep pointing into the buffer, so it sticks around for as long as they do
+	DataOwner = buffer;
 
-	stream.read(buffer, 4);
+	Parse(buffer->data(), buffer->size());
+}
 
-	stream.get(buffer[0]);
-	
-	Endian endian = Endian(buffer[0] ? std::endian::little : std::endian::big);
-	document.Endian = endian;
+void NifDocument::Read(const char* data, size_t dataSize)
+{
+	const char* headerEnd = reinterpret_cast<const char*>(std::memchr(data, 0x0A, dataSize));
 
-	unsigned int userVersion = endian.read<unsigned int>(stream);
-	unsigned int numBlocks = endian.read<unsigned int>(stream);
-	unsigned int metaBlockSize = endian.read<unsigned int>(stream);
-	
-	for (unsigned int currentRemaining = metaBlockSize; currentRemaining <= metaBlockSize; currentRemaining -= bufferSize)
-		stream.read(buffer, std::min(currentRemaining, bufferSize));
+	if (headerEnd == nullptr)
+		throw "unexpected end of nif file";
+
+	std::string headerString(data, headerEnd - data);
+
+	BinaryReader stream(data, dataSize);
+
+	stream.seek(headerString.size() + 1);
+	stream.skip(4);
+
+	::Endian endian = ::Endian(stream.read<char>() ? std::endian::little : std::endian::big);
+	Endian = endian;
+	stream.Endian = endian;
 
-	unsigned short numBlockTypes = endian.read<unsigned short>(stream);
+	unsigned int userVersion = stream.read<unsigned int>();
+	unsigned int numBlocks = stream.read<unsigned int>();
+	unsigned int metaBlockSize = stream.read<unsigned int>();
+
+	stream.skip(metaBlockSize);
+
+	unsigned short numBlockTypes = stream.read<unsigned short>();
 
 	if (numBlockTypes == 0)
 		return;
 
-	document.BlockTypes.resize(numBlockTypes);
-	document.BlockTypeIndices.resize(numBlocks);
-	document.BlockSizes.resize(numBlocks);
+	BlockTypes.resize(numBlockTypes);
+	BlockTypeIndices.resize(numBlocks);
+	BlockSizes.resize(numBlocks);
 
 	for (unsigned short i = 0; i < numBlockTypes; ++i)
 	{
-		unsigned int blockTypeSize = endian.read<unsigned int>(stream);
+		unsigned int blockTypeSize = stream.read<unsigned int>();
 
-		if (blockTypeSize > 0)
-		{
-			stream.read(buffer, blockTypeSize);
-			document.BlockTypes[i].append(buffer, blockTypeSize);
-		}
+		BlockTypes[i].append(stream.readSpan(blockTypeSize), blockTypeSize);
 	}
 
-	for (unsigned int i = 0; i < numBlocks; ++i)
-		document.BlockTypeIndices[i] = 0x7FFF & endian.read<unsigned short>(stream);
+	stream.readArray(BlockTypeIndices.data(), numBlocks);
 
 	for (unsigned int i = 0; i < numBlocks; ++i)
-		document.BlockSizes[i] = endian.read<unsigned int>(stream);
+		BlockTypeIndices[i] &= 0x7FFF;
 
-	unsigned int numStrings = endian.read<unsigned int>(stream);
-	unsigned int maxStringLength = endian.read<unsigned int>(stream);
+	stream.readArray(BlockSizes.data(), numBlocks);
 
-	document.Strings.resize(numStrings);
+	unsigned int numStrings = stream.read<unsigned int>();
+	unsigned int maxStringLength = stream.read<unsigned int>();
+
+	Strings.Reserve(numStrings);
 
 	for (unsigned int i = 0; i < numStrings; ++i)
 	{
-		unsigned int stringLength = endian.read<unsigned int>(stream);
+		unsigned int stringLength = stream.read<unsigned int>();
 
-		if (stringLength > 0)
-		{
-			stream.read(buffer, stringLength);
-			document.Strings[i].append(buffer, stringLength);
-		}
+		Strings.Add(std::string_view(stream.readSpan(stringLength), stringLength));
 	}
 
-	unsigned int numGroups = endian.read<unsigned int>(stream);
+	unsigned int numGroups = stream.read<unsigned int>();
 
 	if (numGroups > 0)
 		throw "WARNING, UNIMPLEMENTED";
 
-	document.Blocks.resize(numBlocks);
+	Blocks.resize(numBlocks);
 
-	for (unsigned int blockIndex = 0; blockIndex < numBlocks; ++blockIndex)
+	// the header has every block's size, so each block's offset is known before any of them are parsed
+	std::vector<size_t> blockOffsets(numBlocks);
+
+	size_t blockOffset = stream.tell();
+
+	for (unsigned int i = 0; i < numBlocks; ++i)
 	{
-		BlockData& block = document.InitializeBlock(blockIndex);
+		blockOffsets[i] = blockOffset;
+		blockOffset += BlockSizes[i];
+	}
 
-		unsigned int position = (unsigned int)stream.tellg();
+	if (blockOffset > dataSize)
+		throw "unexpected end of nif file";
 
-		size_t truncateIndex = 0;
+	// blocks are split into contiguous runs that each parse under their own arena. there are a few more runs than workers so uneven blocks still balance out,
+	// and each run gets about the same number of bytes rather than the same number of blocks
+	Engine::ThreadPool& threadPool = Engine::ThreadPool::GetShared();
 
-		for (truncateIndex; truncateIndex < block.BlockType.size() && block.BlockType[truncateIndex] > 1; ++truncateIndex);
+	const size_t MinimumArenaBlockSize = 1 << 12;
 
-		std::string typeName = block.BlockType.substr(0, truncateIndex);
+	size_t runCount = std::max<size_t>(1, std::min<size_t>((size_t)numBlocks, 4 * (threadPool.GetThreadCount() + 1)));
+	size_t firstOffset = stream.tell();
+	size_t blockBytes = blockOffset - firstOffset;
 
-		if (block.BlockSize > 0)
-		{
-			auto parserIterator = parserFunctions.find(typeName);
+	std::vector<unsigned int> runStarts(runCount + 1, numBlocks);
 
-			if (parserIterator == parserFunctions.end())
-				document.ParserNoOp(stream, block);
-			else
-			{
-				auto iterator = ignoreBlockName.find(typeName);
+	for (size_t i = 0; i < runCount; ++i)
+		runStarts[i] = (unsigned int)(std::lower_bound(blockOffsets.begin(), blockOffsets.end(), firstOffset + blockBytes * i / runCount) - blockOffsets.begin());
 
-				if (iterator == ignoreBlockName.end())
-				{
-					unsigned int name = endian.read<unsigned int>(stream);
+	Arenas.resize(runCount);
 
-					if (name != 0xFFFFFFFFu)
-						block.BlockName = document.Strings[name];
+	for (size_t i = 0; i < runCount; ++i)
+	{
+		size_t runEnd = runStarts[i + 1] < numBlocks ? blockOffsets[runStarts[i + 1]] : blockOffset;
+		size_t runBytes = runStarts[i] < numBlocks ? runEnd - blockOffsets[runStarts[i]] : 0;
 
-					block.BlockStart = 4;
-				}
+		// arenas only reserve once something is allocated, and small runs get small blocks so little files don't reserve a full block per run
+		size_t arenaBlockSize = ArenaBlockSize == 0 ? 0 : std::min(ArenaBlockSize, std::max(MinimumArenaBlockSize, runBytes));
 
-				(document.*(parserIterator->second))(stream, block);
-			}
-		}
+		Arenas[i] = std::make_unique<Engine::MemoryArena>(arenaBlockSize);
+	}
+
+	threadPool.ParallelFor(runCount, [this, &blockOffsets, &runStarts, data, endian](size_t run)
+	{
+		Engine::MemoryArena::Scope arenaScope(*Arenas[run]);
+
+		for (unsigned int blockIndex = runStarts[run]; blockIndex < runStarts[run + 1]; ++blockIndex)
+			ParseBlock(data + blockOffsets[blockIndex], blockIndex, endian);
+	});
+}
+
+void NifDocument::ParseBlock(const char* data, unsigned int blockIndex, ::Endian endian)
+{
+	BlockData& block = InitializeBlock(blockIndex);
 
-		unsigned int parsedInBlock = (unsigned int)stream.tellg() - position;
+	// each block only gets a reader over its own bytes, so a parser that runs long throws instead of reading into the next block
+	BinaryReader stream(data, block.BlockSize, endian);
 
-		if (parsedInBlock != block.BlockSize)
+	size_t truncateIndex = 0;
+
+	for (truncateIndex; truncateIndex < block.BlockType.size() && block.BlockType[truncateIndex] > 1; ++truncateIndex);
+
+	std::string typeName = block.BlockType.substr(0, truncateIndex);
+
+	if (block.BlockSize > 0)
+	{
+		auto parserIterator = parserFunctions.find(typeName);
+
+		if (parserIterator == parserFunctions.end())
+			ParserNoOp(stream, block);
+		else
 		{
-			stream.seekg(position + block.BlockStart);
+			auto iterator = ignoreBlockName.find(typeName);
 
-			auto parserIterator = parserFunctions.find(typeName);
+			if (iterator == ignoreBlockName.end())
+			{
+				block.BlockName = FetchString(stream);
 
-			if (parserIterator == parserFunctions.end())
-				document.ParserNoOp(stream, block);
-			else
-				(document.*(parserIterator->second))(stream, block);
+				block.BlockStart = 4;
+			}
 
-			throw "block parser read wrong amount";
+			(this->*(parserIterator->second))(stream, block);
 		}
 	}
 
+	if (stream.tell() != block.BlockSize)
+		throw "block parser read wrong amount";
+}
+
+void NifParser::Parse(const char* data, size_t dataSize)
+{
+	NifDocument document;
+
+	document.Read(data, dataSize);
+
+	if (document.Blocks.size() == 0)
+		return;
+
+	unsigned int numBlocks = (unsigned int)document.Blocks.size();
+
 	std::map<unsigned int, BlockData*> parents;
 	std::map<unsigned int, size_t> parentEntries;
 	std::map<unsigned int, size_t> parentLinkTypes;
@@ -843,7 +851,7 @@ void NifParser::Parse(std::istream& stream)
 
 					indexBuffer.resize(indexCount);
 
-					const char* buffer = reinterpret_cast<const char*>(stream->StreamData.data());
+					const char* buffer = stream->GetStreamData();
 
 					for (size_t j = 0; j < indexCount; ++j)
 						stream->Attributes[0].Copy(buffer + j * stream->Attributes[0].GetSize(), indexBuffer.data() + j, Enum::AttributeDataType::Int32);
@@ -854,6 +862,7 @@ void NifParser::Parse(std::istream& stream)
 
 			std::vector<Engine::Graphics::VertexAttributeFormat> attributes;
 			std::vector<void*> dataBuffers;
+			std::vector<size_t> dataSizes;
 
 			size_t binding = 0;
 			size_t vertexCount = 0;
@@ -874,7 +883,8 @@ void NifParser::Parse(std::istream& stream)
 				if (semanticsCount != attributeCount)
 					throw "mismatching semantics and attributes";
 
-				dataBuffers.push_back(stream->StreamData.data());
+				dataBuffers.push_back(const_cast<char*>(stream->GetStreamData()));
+				dataSizes.push_back(stream->StreamSize);
 
 				for (size_t j = 0; j < semanticsCount; ++j)
 				{
@@ -912,10 +922,21 @@ void NifParser::Parse(std::istream& stream)
 			mesh.Format = Engine::Graphics::MeshFormat::GetFormat(attributes);
 			mesh.Mesh = Engine::Create<Engine::Graphics::MeshData>();
 			mesh.Mesh->SetFormat(mesh.Format);
-			mesh.Mesh->PushVertices(vertexCount, false);
 			mesh.Mesh->PushIndices(indexBuffer);
 
-			mesh.Format->Copy(dataBuffers.data(), mesh.Mesh->GetData(), mesh.Format, vertexCount);
+			// the format is built from the streams' own layout, so the mesh can use them in place as long as they are big enough
+			bool canAdopt = DataOwner != nullptr && dataBuffers.size() == mesh.Format->GetBindingCount();
+
+			for (size_t i = 0; canAdopt && i < dataSizes.size(); ++i)
+				canAdopt = dataSizes[i] >= vertexCount * mesh.Format->GetVertexSize(i);
+
+			if (canAdopt)
+				mesh.Mesh->AdoptVertices(vertexCount, dataBuffers.data(), DataOwner);
+			else
+			{
+				mesh.Mesh->PushVertices(vertexCount, false);
+				mesh.Format->Copy(dataBuffers.data(), mesh.Mesh->GetData(), mesh.Format, vertexCount);
+			}
 
 			ImportedMeshes.push_back(mesh);
 
@@ -25,6 +25,8 @@ class NifParser
 public:
 	std::vector<ImportedNiMesh> ImportedMeshes;
 	Engine::Graphics::ModelPackage* Package = nullptr;
+	std::shared_ptr<const void> DataOwner; // set when the parsed data outlives Parse, lets meshes use vertex streams in place
 
 	void Parse(std::istream& stream);
+	void Parse(const char* data, size_t size);
 };
\ No newline at end of file
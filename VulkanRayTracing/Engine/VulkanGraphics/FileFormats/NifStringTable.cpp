@@ -0,0 +1,126 @@
+#include "NifStringTable.h"
+
+import <functional>;
+import <algorithm>;
+
+unsigned int NifStringTable::Intern(std::string_view text)
+{
+	size_t hash = std::hash<std::string_view>()(text);
+
+	// keep the table at most half full so probe runs stay short
+	if (2 * (Strings.size() + 1) > Slots.size())
+		Rehash(std::max<size_t>(64, 2 * Slots.size()));
+
+	Slot& slot = Slots[FindSlot(text, hash)];
+
+	if (slot.Index != NoString)
+		return slot.Index;
+
+	slot.Hash = hash;
+	slot.Index = (unsigned int)Strings.size();
+
+	Strings.push_back(std::string(text));
+	MaxLength = std::max(MaxLength, (unsigned int)text.size());
+
+	return slot.Index;
+}
+
+unsigned int NifStringTable::Add(std::string_view text)
+{
+	size_t hash = std::hash<std::string_view>()(text);
+
+	if (2 * (Strings.size() + 1) > Slots.size())
+		Rehash(std::max<size_t>(64, 2 * Slots.size()));
+
+	unsigned int index = (unsigned int)Strings.size();
+
+	Strings.push_back(std::string(text));
+	MaxLength = std::max(MaxLength, (unsigned int)text.size());
+
+	// files can repeat a string, refs into the table still have to land on the entry they were written against so only the first copy gets indexed
+	Slot& slot = Slots[FindSlot(text, hash)];
+
+	if (slot.Index == NoString)
+	{
+		slot.Hash = hash;
+		slot.Index = index;
+	}
+
+	return index;
+}
+
+unsigned int NifStringTable::Find(std::string_view text) const
+{
+	if (Slots.size() == 0)
+		return NoString;
+
+	return Slots[FindSlot(text, std::hash<std::string_view>()(text))].Index;
+}
+
+const std::string& NifStringTable::Fetch(unsigned int ref) const
+{
+	static const std::string emptyString;
+
+	if (ref == NoString) return emptyString;
+
+	if (ref >= Strings.size())
+		throw "nif string ref out of range";
+
+	return Strings[ref];
+}
+
+void NifStringTable::Reserve(size_t count)
+{
+	Strings.reserve(count);
+
+	size_t slotCount = 64;
+
+	while (slotCount < 2 * count)
+		slotCount *= 2;
+
+	if (slotCount > Slots.size())
+		Rehash(slotCount);
+}
+
+void NifStringTable::Clear()
+{
+	Strings.clear();
+	Slots.clear();
+	MaxLength = 0;
+}
+
+size_t NifStringTable::FindSlot(std::string_view text, size_t hash) const
+{
+	size_t mask = Slots.size() - 1;
+
+	for (size_t i = hash & mask; true; i = (i + 1) & mask)
+	{
+		const Slot& slot = Slots[i];
+
+		if (slot.Index == NoString || (slot.Hash == hash && Strings[slot.Index] == text))
+			return i;
+	}
+}
+
+void NifStringTable::Rehash(size_t slotCount)
+{
+	std::vector<Slot> oldSlots;
+
+	oldSlots.swap(Slots);
+	Slots.resize(slotCount);
+
+	size_t mask = slotCount - 1;
+
+	for (size_t i = 0; i < oldSlots.size(); ++i)
+	{
+		if (oldSlots[i].Index == NoString)
+			continue;
+
+		size_t j = oldSlots[i].Hash & mask;
+
+		while (Slots[j].Index != NoString)
+			j = (j + 1) & mask;
+
+		Slots[j] = oldSlots[i];
+	}
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+import <vector>;
+import <string>;
+import <string_view>;
+
+class NifStringTable
+{
+public:
+	static const unsigned int NoString = 0xFFFFFFFFu;
+
+	unsigned int Intern(std::string_view text);
+	unsigned int Add(std::string_view text);
+	unsigned int Find(std::string_view text) const;
+	const std::string& Fetch(unsigned int ref) const;
+	const std::string& Get(size_t index) const { return Strings[index]; }
+	size_t GetCount() const { return Strings.size(); }
+	unsigned int GetMaxLength() const { return MaxLength; }
+	void Reserve(size_t count);
+	void Clear();
+
+private:
+	struct Slot
+	{
+		size_t Hash = 0;
+		unsigned int Index = NoString;
+	};
+
+	std::vector<std::string> Strings;
+	std::vector<Slot> Slots;
+	unsigned int MaxLength = 0;
+
+	size_t FindSlot(std::string_view text, size_t hash) const;
+	void Rehash(size_t slotCount);
+};
@@ -3,6 +3,7 @@
 import <map>;
 
 #include <Engine/Objects/Transform.h>
+#include <Engine/ThreadPool.h>
 
 #include "NifBlockTypes.h"
 #include "PackageNodes.h"
@@ -47,8 +48,8 @@ std::map<std::string, NifDocument::BlockWriteFunction> writeFunctions = {
 	{ "NiDataStream", &NifDocument::WriteDataStream }
 };
 
-template <typename T>
-void write(std::ostream& stream, const T& value)
+template <typename Stream, typename T>
+void write(Stream& stream, const T& value)
 {
 	const size_t length = sizeof(T);
 	stream.write(reinterpret_cast<const char*>(&value), length);
@@ -58,7 +59,12 @@ void NifWriter::Write(std::ostream& stream)
 {
 	NifDocument document;
 
-	std::map<size_t, BlockData*> nodeMap;
+	// also detaches dangling and cyclic links, so the parent walks below always end
+	if (!Package->HasHierarchy())
+		Package->BuildHierarchy();
+
+	std::vector<BlockData*> nodeBlocks(Package->Nodes.size());
+	std::vector<size_t> linkParents(Package->Nodes.size());
 	std::map<size_t, BlockData*> materialMap;
 	std::map<size_t, BlockData*> materialTextureMap;
 	std::shared_ptr<Engine::Graphics::MeshFormat> format = GetNiMeshFormat();
@@ -83,48 +89,42 @@ void NifWriter::Write(std::ostream& stream)
 			nodeTypeData = nodeData;
 		}
 
-		nodeTypeData->Transformation.Translation = node.Transform->GetTransformation().Translation();
-		nodeTypeData->Transformation.Rotation.ExtractRotation(node.Transform->GetTransformation());
+		Matrix4 transformation = node.Transform->GetTransformation();
+		size_t parent = node.AttachedTo;
+
+		// meshes can't hold children in the nif, so anything under one moves up to the nearest plain node with the mesh transforms folded in
+		for (; parent != (size_t)-1 && Package->Nodes[parent].Mesh != nullptr; parent = Package->Nodes[parent].AttachedTo)
+			transformation = Package->Nodes[parent].Transform->GetTransformation() * transformation;
+
+		if (parent != node.AttachedTo)
+		{
+			if (parent != (size_t)-1)
+				std::cout << "warning: node attached to a mesh in package exported to nif, moved up to '" << Package->Nodes[parent].Name << "': " << node.Name << std::endl;
+			else
+				std::cout << "warning: node attached to a mesh in package exported to nif, exported as a root: " << node.Name << std::endl;
+		}
+
+		linkParents[i] = parent;
 
-		Vector3SF scale = node.Transform->GetTransformation().ExtractScale();
+		nodeTypeData->Transformation.Translation = transformation.Translation();
+		nodeTypeData->Transformation.Rotation.ExtractRotation(transformation);
+
+		Vector3SF scale = transformation.ExtractScale();
 
 		if (!(compare(scale.X, scale.Y) && compare(scale.Y, scale.Z)))
 			std::cout << "warning: nonuniform scaling used in package exported to nif: " << node.Name << " " << scale << std::endl;
 
 		nodeTypeData->Transformation.Scale = std::max(std::max(scale.X, scale.Y), scale.Z);
 
-		if (node.AttachedTo == (size_t)-1)
+		if (parent == (size_t)-1)
 		{
 			nodeTypeData->Properties.push_back(document.MakeProperty<NiVertexColorProperty>("", 8));
 			nodeTypeData->Properties.push_back(document.MakeProperty<NiZBufferProperty>("", 15));
 		}
 
-		nodeMap[i] = &block;
+		nodeBlocks[i] = &block;
 
-		if (node.AttachedTo != (size_t)-1)
-		{
-			auto parentIndex = nodeMap.find(node.AttachedTo);
-
-			if (parentIndex != nodeMap.end())
-				parentIndex->second->GetData<NiNode>()->Children.push_back(&block);
-		}
-		
-		if (nodeData != nullptr)
-		{
-			for (size_t j = 0; j < Package->Nodes.size(); ++j)
-			{
-				size_t attachedTo = Package->Nodes[j].AttachedTo;
-
-				if (attachedTo == i)
-				{
-					auto childIndex = nodeMap.find(j);
-
-					if (childIndex != nodeMap.end())
-						nodeData->Children.push_back(childIndex->second);
-				}
-			}
-		}
-		else
+		if (nodeData == nullptr)
 		{
 			meshData->ExtraData.push_back(document.MakeExtraData<NiFloatExtraData>("FresnelBoost", 5));
 			meshData->ExtraData.push_back(document.MakeExtraData<NiFloatExtraData>("FresnelExponent", 4));
@@ -299,10 +299,9 @@ void NifWriter::Write(std::ostream& stream)
 			stream1->Streamable = true;
 			stream1->StreamData.resize(2 * indexBuffer.size());
 
-			unsigned short* outIndexBuffer = reinterpret_cast<unsigned short*>(stream1->StreamData.data());
+			ConversionKernel convertIndices = GetConversionKernel(Enum::AttributeDataType::Int32, Enum::AttributeDataType::UInt16);
 
-			for (size_t i = 0; i < indexBuffer.size(); ++i)
-				outIndexBuffer[i] = (unsigned short)indexBuffer[i];
+			convertIndices(reinterpret_cast<const char*>(indexBuffer.data()), stream1->StreamData.data(), sizeof(int), sizeof(unsigned short), indexBuffer.size(), 1);
 
 			BlockData& stream2Block = document.MakeBlock("");
 			NiDataStream* stream2 = stream2Block.MakeType<NiDataStream>();
@@ -374,8 +373,19 @@ void NifWriter::Write(std::ostream& stream)
 		}
 	}
 
-	std::vector<std::stringstream> blockStreams(document.BlockMap.size());
+	// only plain nodes carry a child list, meshes are always leaves in the nif
+	for (size_t i = 0; i < Package->Nodes.size(); ++i)
+		if (linkParents[i] != (size_t)-1)
+			nodeBlocks[linkParents[i]]->GetData<NiNode>()->Children.push_back(nodeBlocks[i]);
+
+	std::vector<BlockData*> blocks;
+	std::vector<NifDocument::BlockWriteFunction> blockWriters;
+	std::map<std::string, unsigned short> blockTypeIndices;
+
+	blocks.reserve(document.BlockMap.size());
+	blockWriters.reserve(document.BlockMap.size());
 
+	// first pass only measures, which sizes every block and interns strings in the same order a serial write would
 	for (auto index = document.BlockMap.begin(); index != document.BlockMap.end(); ++index)
 	{
 		BlockData& block = index->second;
@@ -390,112 +400,127 @@ void NifWriter::Write(std::ostream& stream)
 
 		if (iterator == writeFunctions.end())
 			throw "unsupported nif block type export";
-		else
-			(document.*(iterator->second))(blockStreams[index->first], block);
 
-		auto addBlockType = [this, &block, &document]()
-		{
-			for (size_t i = 0; i < document.BlockTypes.size(); ++i)
-			{
-				if (document.BlockTypes[i] == block.BlockType)
-				{
-					document.BlockTypeIndices.push_back((unsigned short)i);
-
-					return;
-				}
-			}
+		BinaryWriter measure;
 
-			document.BlockTypeIndices.push_back((unsigned short)document.BlockTypes.size());
-			document.BlockTypes.push_back(block.BlockType);
-		};
+		(document.*(iterator->second))(measure, block);
 
-		addBlockType();
+		auto blockType = blockTypeIndices.find(block.BlockType);
 
-		blockStreams[index->first].seekg(0, std::ios::end);
+		if (blockType == blockTypeIndices.end())
+		{
+			blockType = blockTypeIndices.insert(std::make_pair(block.BlockType, (unsigned short)document.BlockTypes.size())).first;
 
-		document.BlockSizes.push_back((unsigned int)blockStreams[index->first].tellg());
-	}
+			document.BlockTypes.push_back(block.BlockType);
+		}
 
-	stream << "Gamebryo File Format, Version 30.2.0.3";
+		document.BlockTypeIndices.push_back(blockType->second);
+		document.BlockSizes.push_back((unsigned int)measure.tell());
 
-	char version[] = { 10, 3, 0, 2, 30, (unsigned char)(std::endian::native == std::endian::little) };
+		blocks.push_back(&block);
+		blockWriters.push_back(iterator->second);
+	}
 
-	stream.write(version, 6);
+	const char header[] = "Gamebryo File Format, Version 30.2.0.3";
+	const char version[] = { 10, 3, 0, 2, 30, (unsigned char)(std::endian::native == std::endian::little) };
 
 	unsigned int userVersion = 0;
-	unsigned int numBlocks = (unsigned int)blockStreams.size();
+	unsigned int numBlocks = (unsigned int)blocks.size();
 	unsigned int metaBlockSize = 0;
 	unsigned short numBlockTypes = (unsigned short)document.BlockTypes.size();
+	unsigned int numStrings = (unsigned int)document.Strings.GetCount();
+	unsigned int maxStringLength = document.Strings.GetMaxLength();
+	unsigned int numGroups = 0;
 
-	size_t pos = stream.tellp();
-	write(stream, userVersion);
-	write(stream, numBlocks);
-	write(stream, metaBlockSize);
-	write(stream, numBlockTypes);
-	pos = stream.tellp();
-
-	for (size_t i = 0; i < document.BlockTypes.size(); ++i)
+	auto writeHeader = [&](BinaryWriter& stream)
 	{
-		unsigned int length = (unsigned int)document.BlockTypes[i].size();
+		stream.write(header, sizeof(header) - 1);
+		stream.write(version, sizeof(version));
 
-		write(stream, length);
+		write(stream, userVersion);
+		write(stream, numBlocks);
+		write(stream, metaBlockSize);
+		write(stream, numBlockTypes);
 
-		stream.write(document.BlockTypes[i].c_str(), length);
-	}
+		for (size_t i = 0; i < document.BlockTypes.size(); ++i)
+		{
+			unsigned int length = (unsigned int)document.BlockTypes[i].size();
 
-	stream.write(reinterpret_cast<char*>(document.BlockTypeIndices.data()), numBlocks * sizeof(document.BlockTypeIndices[0]));
-	stream.write(reinterpret_cast<char*>(document.BlockSizes.data()), numBlocks * sizeof(document.BlockSizes[0]));
+			write(stream, length);
 
-	unsigned int numStrings = (unsigned int)document.Strings.size();
-	unsigned int maxStringLength = 0;
+			stream.write(document.BlockTypes[i].c_str(), length);
+		}
 
-	for (size_t i = 0; i < document.Strings.size(); ++i)
-		maxStringLength = std::max(maxStringLength, (unsigned int)document.Strings[i].size());
+		stream.write(reinterpret_cast<char*>(document.BlockTypeIndices.data()), numBlocks * sizeof(document.BlockTypeIndices[0]));
+		stream.write(reinterpret_cast<char*>(document.BlockSizes.data()), numBlocks * sizeof(document.BlockSizes[0]));
 
-	write(stream, numStrings);
-	write(stream, maxStringLength);
+		write(stream, numStrings);
+		write(stream, maxStringLength);
 
-	for (size_t i = 0; i < document.Strings.size(); ++i)
-	{
-		unsigned int length = (unsigned int)document.Strings[i].size();
+		for (size_t i = 0; i < document.Strings.GetCount(); ++i)
+		{
+			const std::string& text = document.Strings.Get(i);
+			unsigned int length = (unsigned int)text.size();
 
-		write(stream, length);
+			write(stream, length);
 
-		stream.write(document.Strings[i].c_str(), length);
-	}
+			stream.write(text.c_str(), length);
+		}
 
-	unsigned int numGroups = 0;
+		write(stream, numGroups);
+	};
+
+	BinaryWriter headerSize;
+
+	writeHeader(headerSize);
 
-	write(stream, numGroups);
+	std::vector<size_t> blockOffsets(blocks.size());
+	size_t fileSize = headerSize.tell();
 
-	for (size_t i = 0; i < blockStreams.size(); ++i)
+	for (size_t i = 0; i < blocks.size(); ++i)
 	{
-		std::string block = blockStreams[i].str();
-		stream.write(block.c_str(), block.size());
+		blockOffsets[i] = fileSize;
+		fileSize += document.BlockSizes[i];
 	}
 
-	blockStreams[0].tellg();
+	std::unique_ptr<char[]> buffer(new char[fileSize]);
+
+	BinaryWriter headerStream(buffer.get(), headerSize.tell());
+
+	writeHeader(headerStream);
+
+	// with the string table frozen every block only reads shared state, so each one can fill its own slice of the buffer at the same time
+	Engine::ThreadPool::GetShared().ParallelFor(blocks.size(), [&](size_t i)
+	{
+		BinaryWriter blockStream(buffer.get() + blockOffsets[i], document.BlockSizes[i]);
+
+		(document.*(blockWriters[i]))(blockStream, *blocks[i]);
+
+		if (blockStream.tell() != document.BlockSizes[i])
+			throw "nif block size changed between measuring and writing";
+	});
+
+	stream.write(buffer.get(), fileSize);
 }
 
-void NifDocument::WriteString(std::ostream& stream, const std::string& text)
+void NifDocument::WriteString(BinaryWriter& stream, const std::string& text)
 {
-	for (unsigned int i = 0; i < Strings.size(); ++i)
+	if (stream.isMeasuring())
 	{
-		if (Strings[i] == text)
-		{
-			write(stream, i);
+		write(stream, Strings.Intern(text));
 
-			return;
-		}
+		return;
 	}
 
-	unsigned int index = (unsigned int)Strings.size();
-	Strings.push_back(text);
+	unsigned int index = Strings.Find(text);
+
+	if (index == NifStringTable::NoString)
+		throw "nif string written without being measured first";
 
 	write(stream, index);
 }
 
-void NifDocument::WriteRef(std::ostream& stream, const BlockData* block)
+void NifDocument::WriteRef(BinaryWriter& stream, const BlockData* block)
 {
 	if (block == nullptr)
 		write(stream, (unsigned int)-1);
@@ -503,14 +528,14 @@ void NifDocument::WriteRef(std::ostream& stream, const BlockData* block)
 		write(stream, block->BlockIndex);
 }
 
-void NifDocument::WriteMatrix(std::ostream& stream, const Matrix4F& block)
+void NifDocument::WriteMatrix(BinaryWriter& stream, const Matrix4F& block)
 {
 	write(stream, Vector3SF(block.RightVector()));
 	write(stream, Vector3SF(block.UpVector()));
 	write(stream, Vector3SF(block.FrontVector()));
 }
 
-void NifDocument::WriteNode(std::ostream& stream, BlockData& block)
+void NifDocument::WriteNode(BinaryWriter& stream, BlockData& block)
 {
 	NiNode* data = block.GetData<NiNode>();
 
@@ -545,7 +570,7 @@ void NifDocument::WriteNode(std::ostream& stream, BlockData& block)
 		WriteRef(stream, data->Effects[i]);
 }
 
-void NifDocument::WriteMesh(std::ostream& stream, BlockData& block)
+void NifDocument::WriteMesh(BinaryWriter& stream, BlockData& block)
 {
 	NiMesh* data = block.GetData<NiMesh>();
 
@@ -611,7 +636,7 @@ void NifDocument::WriteMesh(std::ostream& stream, BlockData& block)
 		WriteRef(stream, data->Modifiers[i]);
 }
 
-void NifDocument::WriteVertexColorProperty(std::ostream& stream, BlockData& block)
+void NifDocument::WriteVertexColorProperty(BinaryWriter& stream, BlockData& block)
 {
 	NiProperty* data = block.GetData<NiProperty>();
 
@@ -626,7 +651,7 @@ void NifDocument::WriteVertexColorProperty(std::ostream& stream, BlockData& bloc
 	write(stream, data->Flags);
 }
 
-void NifDocument::WriteZBufferProperty(std::ostream& stream, BlockData& block)
+void NifDocument::WriteZBufferProperty(BinaryWriter& stream, BlockData& block)
 {
 	NiProperty* data = block.GetData<NiProperty>();
 
@@ -641,7 +666,7 @@ void NifDocument::WriteZBufferProperty(std::ostream& stream, BlockData& block)
 	write(stream, data->Flags);
 }
 
-void NifDocument::WriteSpecularProperty(std::ostream& stream, BlockData& block)
+void NifDocument::WriteSpecularProperty(BinaryWriter& stream, BlockData& block)
 {
 	NiProperty* data = block.GetData<NiProperty>();
 
@@ -656,7 +681,7 @@ void NifDocument::WriteSpecularProperty(std::ostream& stream, BlockData& block)
 	write(stream, data->Flags);
 }
 
-void NifDocument::WriteMaterialProperty(std::ostream& stream, BlockData& block)
+void NifDocument::WriteMaterialProperty(BinaryWriter& stream, BlockData& block)
 {
 	NiMaterialProperty* data = block.GetData<NiMaterialProperty>();
 
@@ -676,7 +701,7 @@ void NifDocument::WriteMaterialProperty(std::ostream& stream, BlockData& block)
 	write(stream, data->Alpha);
 }
 
-void NifDocument::WriteTexturingProperty(std::ostream& stream, BlockData& block)
+void NifDocument::WriteTexturingProperty(BinaryWriter& stream, BlockData& block)
 {
 	NiTexturingProperty* data = block.GetData<NiTexturingProperty>();
 
@@ -731,7 +756,7 @@ void NifDocument::WriteTexturingProperty(std::ostream& stream, BlockData& block)
 	}
 }
 
-void NifDocument::WriteSourceTexture(std::ostream& stream, BlockData& block)
+void NifDocument::WriteSourceTexture(BinaryWriter& stream, BlockData& block)
 {
 	NiSourceTexture* data = block.GetData<NiSourceTexture>();
 
@@ -754,7 +779,7 @@ void NifDocument::WriteSourceTexture(std::ostream& stream, BlockData& block)
 	write(stream, (unsigned char)data->PersistRenderData);
 }
 
-void NifDocument::WriteFloatExtraData(std::ostream& stream, BlockData& block)
+void NifDocument::WriteFloatExtraData(BinaryWriter& stream, BlockData& block)
 {
 	NiFloatExtraData* data = block.GetData<NiFloatExtraData>();
 
@@ -762,7 +787,7 @@ void NifDocument::WriteFloatExtraData(std::ostream& stream, BlockData& block)
 	write(stream, data->Value);
 }
 
-void NifDocument::WriteColorExtraData(std::ostream& stream, BlockData& block)
+void NifDocument::WriteColorExtraData(BinaryWriter& stream, BlockData& block)
 {
 	NiColorExtraData* data = block.GetData<NiColorExtraData>();
 
@@ -770,7 +795,7 @@ void NifDocument::WriteColorExtraData(std::ostream& stream, BlockData& block)
 	write(stream, data->Value);
 }
 
-void NifDocument::WriteIntegerExtraData(std::ostream& stream, BlockData& block)
+void NifDocument::WriteIntegerExtraData(BinaryWriter& stream, BlockData& block)
 {
 	NiIntegerExtraData* data = block.GetData<NiIntegerExtraData>();
 
@@ -778,7 +803,7 @@ void NifDocument::WriteIntegerExtraData(std::ostream& stream, BlockData& block)
 	write(stream, data->Value);
 }
 
-void NifDocument::WriteMorphWeightsController(std::ostream& stream, BlockData& block)
+void NifDocument::WriteMorphWeightsController(BinaryWriter& stream, BlockData& block)
 {
 	NiMorphWeightsController* data = block.GetData<NiMorphWeightsController>();
 
@@ -802,7 +827,7 @@ void NifDocument::WriteMorphWeightsController(std::ostream& stream, BlockData& b
 		WriteString(stream, data->TargetNames[i]);
 }
 
-void NifDocument::WriteFloatInterpolator(std::ostream& stream, BlockData& block)
+void NifDocument::WriteFloatInterpolator(BinaryWriter& stream, BlockData& block)
 {
 	NiFloatInterpolator* data = block.GetData<NiFloatInterpolator>();
 
@@ -810,7 +835,7 @@ void NifDocument::WriteFloatInterpolator(std::ostream& stream, BlockData& block)
 	WriteRef(stream, data->Data);
 }
 
-void NifDocument::WriteFloatData(std::ostream& stream, BlockData& block)
+void NifDocument::WriteFloatData(BinaryWriter& stream, BlockData& block)
 {
 	NiFloatData* data = block.GetData<NiFloatData>();
 
@@ -824,7 +849,7 @@ void NifDocument::WriteFloatData(std::ostream& stream, BlockData& block)
 	}
 }
 
-void NifDocument::WriteMorphMeshModifier(std::ostream& stream, BlockData& block)
+void NifDocument::WriteMorphMeshModifier(BinaryWriter& stream, BlockData& block)
 {
 	NiMorphMeshModifier* data = block.GetData<NiMorphMeshModifier>();
 
@@ -851,7 +876,7 @@ void NifDocument::WriteMorphMeshModifier(std::ostream& stream, BlockData& block)
 	}
 }
 
-void NifDocument::WriteDataStream(std::ostream& stream, BlockData& block)
+void NifDocument::WriteDataStream(BinaryWriter& stream, BlockData& block)
 {
 	NiDataStream* data = block.GetData<NiDataStream>();
 
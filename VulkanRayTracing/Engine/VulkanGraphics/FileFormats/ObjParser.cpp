@@ -4,6 +4,13 @@ import <cmath>;
 import <fstream>;
 import <sstream>;
 import <exception>;
+import <charconv>;
+import <string_view>;
+import <cstring>;
+import <algorithm>;
+
+#include <Engine/ThreadPool.h>
+#include <Engine/Assets/MappedFile.h>
 
 namespace Engine
 {
@@ -37,11 +44,8 @@ namespace Engine
 			return normal;
 		}
 
-		void ObjParser::Parse(std::istream& file, const std::string& filePath)
+		void ObjParser::ParseCharacters(std::istream& file, const std::string& filePath)
 		{
-			unsigned int col = Color4(0.5f, 1, 0.25f, 1);
-			Color4 rgb = Color4(col);
-
 			Mode = ParseMode::Seek;
 
 			Token.clear();
@@ -81,54 +85,372 @@ namespace Engine
 				if (Token.size() > 0)
 					EvaluateToken();
 
-				for (int index = 0; index < int(Faces.size()); ++index)
+				FinishFaces();
+			}
+			catch (std::string& error)
+			{
+				throw Output(filePath, line, error);
+			}
+		}
+
+		void ObjParser::FinishFaces()
+		{
+			for (int index = 0; index < int(Faces.size()); ++index)
+			{
+				auto i = &Faces[index];
+
+				Vector3F normal = (Vertices[i->Vertices[1].Position] - Vertices[i->Vertices[0].Position]).Cross(Vertices[i->Vertices[2].Position] - Vertices[i->Vertices[0].Position]);
+
+				float length = normal.SquareLength();
+
+				if (length < 1e-15)
 				{
-					auto i = &Faces[index];
+					std::swap(Faces[index], Faces.back());
+					Faces.pop_back();
+					--index;
 
-					Vector3F normal = (Vertices[i->Vertices[1].Position] - Vertices[i->Vertices[0].Position]).Cross(Vertices[i->Vertices[2].Position] - Vertices[i->Vertices[0].Position]);
+					continue;
+				}
+
+				normal *= 1 / std::sqrt(length);
 
-					float length = normal.SquareLength();
+				for (int j = 0; j < 3; ++j)
+				{
+					Vertex& vertex = i->Vertices[j];
 
-					if (length < 1e-15)
+					if (vertex.Normal == -1)
 					{
-						std::swap(Faces[index], Faces.back());
-						Faces.pop_back();
-						--index;
+						vertex.Normal = int(Normals.size());
+						Normals.push_back(normal);
+					}
+
+					if (vertex.Color == -1)
+						vertex.Color = int(Colors.size());
+
+					if (vertex.UV == -1)
+						vertex.UV = int(UVs.size());
+				}
+			}
+
+			Colors.push_back(Color4(1.f, 1.f, 1.f, 1.f));
+			UVs.push_back(Vector3F());
+		}
+
+		struct ObjIndexFixup
+		{
+			size_t Face = 0;
+			unsigned char Vertex = 0;
+			unsigned char Component = 0;
+		};
+
+		struct ObjChunk
+		{
+			std::vector<Vector3F> Vertices;
+			std::vector<Vector3F> UVs;
+			std::vector<Vector3F> Normals;
+			std::vector<Face> Faces;
+			std::vector<ObjIndexFixup> Fixups;
+
+			std::string Error;
+			const char* ErrorPosition = nullptr;
+		};
+
+		bool IsObjSpace(char character)
+		{
+			return character == ' ' || character == '\t' || character == '\r';
+		}
+
+		const char* SkipObjSpaces(const char* position, const char* end)
+		{
+			while (position < end && IsObjSpace(*position))
+				++position;
+
+			return position;
+		}
+
+		const char* FindObjTokenEnd(const char* position, const char* end)
+		{
+			while (position < end && !IsObjSpace(*position))
+				++position;
+
+			return position;
+		}
+
+		float ReadObjFloat(const char* begin, const char* end)
+		{
+			float value = 0;
+
+			// from_chars doesn't take a leading plus, atof did
+			if (begin < end && *begin == '+')
+				++begin;
+
+			if (std::from_chars(begin, end, value).ec != std::errc())
+				return 0;
+
+			return value;
+		}
+
+		// reads up to count floats off the rest of the line, returning how many there were
+		size_t ReadObjFloats(const char* position, const char* end, float* values, size_t count, const char* tooMany)
+		{
+			size_t read = 0;
+
+			for (position = SkipObjSpaces(position, end); position < end; position = SkipObjSpaces(position, end))
+			{
+				const char* tokenEnd = FindObjTokenEnd(position, end);
+
+				if (read == count)
+					throw std::string(tooMany);
+
+				values[read++] = ReadObjFloat(position, tokenEnd);
+				position = tokenEnd;
+			}
+
+			return read;
+		}
+
+		void ReadObjVertex(const char* position, const char* end, ObjChunk& chunk, Vertex& vertex, unsigned char vertexIndex)
+		{
+			size_t counts[3] = { chunk.Vertices.size(), chunk.UVs.size(), chunk.Normals.size() };
+
+			vertex.Position = -1;
+			vertex.UV = -1;
+			vertex.Normal = -1;
+
+			int* components[3] = { &vertex.Position, &vertex.UV, &vertex.Normal };
+
+			for (unsigned char component = 0; position <= end; ++component)
+			{
+				const char* numberEnd = std::find(position, end, '/');
+
+				if (numberEnd > position)
+				{
+					if (component > 2)
+						throw std::string("too many vertex parameters");
+
+					int number = 0;
+
+					if (*position == '+')
+						++position;
+
+					std::from_chars(position, numberEnd, number);
+
+					if (number < 0)
+					{
+						// relative to what this chunk has read so far, the chunk's base gets added in once every chunk is done
+						*components[component] = (int)counts[component] + number;
+
+						chunk.Fixups.push_back(ObjIndexFixup{ chunk.Faces.size(), vertexIndex, component });
+					}
+					else
+						*components[component] = number - 1;
+				}
+
+				position = numberEnd + 1;
+			}
+		}
+
+		void ParseObjChunk(const char* position, const char* end, ObjChunk& chunk)
+		{
+			Face polygon;
+
+			while (position < end)
+			{
+				const char* lineEnd = reinterpret_cast<const char*>(std::memchr(position, '\n', end - position));
+
+				if (lineEnd == nullptr)
+					lineEnd = end;
+
+				const char* lineStart = position;
+
+				try
+				{
+					position = SkipObjSpaces(position, lineEnd);
+
+					if (position == lineEnd || *position == '#')
+					{
+						position = lineEnd + 1;
 
 						continue;
 					}
 
-					normal *= 1 / std::sqrt(length);
+					const char* keywordEnd = FindObjTokenEnd(position, lineEnd);
+					std::string_view keyword(position, keywordEnd - position);
+
+					position = keywordEnd;
 
-					for (int j = 0; j < 3; ++j)
+					float values[3] = {};
+
+					if (keyword == "v")
+					{
+						if (ReadObjFloats(position, lineEnd, values, 3, "too many vector parameters") == 3)
+							chunk.Vertices.push_back(Vector3F(values[0], values[1], values[2], 1));
+					}
+					else if (keyword == "vt")
+					{
+						if (ReadObjFloats(position, lineEnd, values, 2, "too many vector2 parameters") == 2)
+							chunk.UVs.push_back(Vector3F(values[0], values[1], 0, 0));
+					}
+					else if (keyword == "vn")
 					{
-						Vertex& vertex = i->Vertices[j];
+						if (ReadObjFloats(position, lineEnd, values, 3, "too many vector parameters") == 3)
+							chunk.Normals.push_back(Vector3F(values[0], values[1], values[2], 0));
+					}
+					else if (keyword == "f")
+					{
+						size_t fixups = chunk.Fixups.size();
+						unsigned char vertices = 0;
 
-						if (vertex.Normal == -1)
+						for (position = SkipObjSpaces(position, lineEnd); position < lineEnd; position = SkipObjSpaces(position, lineEnd))
 						{
-							vertex.Normal = int(Normals.size());
-							Normals.push_back(normal);
-						}
+							const char* tokenEnd = FindObjTokenEnd(position, lineEnd);
 
-						if (vertex.Color == -1)
-							vertex.Color = int(Colors.size());
+							if (vertices == 3)
+								throw std::string("model isn't triangulated");
 
-						if (vertex.UV == -1)
-							vertex.UV = int(UVs.size());
+							ReadObjVertex(position, tokenEnd, chunk, polygon.Vertices[vertices], vertices);
+
+							++vertices;
+							position = tokenEnd;
+						}
+
+						// faces with less than three corners get dropped, same as they always have
+						if (vertices == 3)
+							chunk.Faces.push_back(polygon);
+						else
+							chunk.Fixups.resize(fixups);
 					}
+					else if (keyword != "mtllib" && keyword != "usemtl" && keyword != "o" && keyword != "g" && keyword != "s")
+						throw std::string("unsupported data");
 				}
+				catch (std::string& error)
+				{
+					chunk.Error = error;
+					chunk.ErrorPosition = lineStart;
 
-				Colors.push_back(Color4(1.f, 1.f, 1.f, 1.f));
-				UVs.push_back(Vector3F());
+					return;
+				}
+
+				position = lineEnd + 1;
 			}
-			catch (std::string& error)
+		}
+
+		void ObjParser::Parse(const char* data, size_t size, const std::string& filePath)
+		{
+			const size_t MinimumChunkSize = 1 << 20;
+
+			Faces.clear();
+			Vertices.clear();
+			UVs.clear();
+			Normals.clear();
+
+			ThreadPool& pool = ThreadPool::GetShared();
+
+			size_t chunkCount = std::max<size_t>(1, std::min(pool.GetThreadCount() + 1, size / MinimumChunkSize));
+
+			// chunks get cut at line breaks so no line is split between two of them
+			std::vector<const char*> boundaries(chunkCount + 1, data + size);
+
+			boundaries[0] = data;
+
+			for (size_t i = 1; i < chunkCount; ++i)
 			{
-				throw Output(filePath, line, error);
+				const char* target = std::max(boundaries[i - 1], data + i * (size / chunkCount));
+				const char* lineEnd = reinterpret_cast<const char*>(std::memchr(target, '\n', data + size - target));
+
+				boundaries[i] = lineEnd == nullptr ? data + size : lineEnd + 1;
+			}
+
+			std::vector<ObjChunk> chunks(chunkCount);
+
+			pool.ParallelFor(chunkCount, [&chunks, &boundaries](size_t i)
+			{
+				ParseObjChunk(boundaries[i], boundaries[i + 1], chunks[i]);
+			});
+
+			for (size_t i = 0; i < chunkCount; ++i)
+			{
+				if (chunks[i].ErrorPosition != nullptr)
+				{
+					int line = (int)std::count(data, chunks[i].ErrorPosition, '\n');
+
+					throw Output(filePath, line, chunks[i].Error);
+				}
 			}
+
+			struct ChunkBase
+			{
+				size_t Vertices = 0;
+				size_t UVs = 0;
+				size_t Normals = 0;
+				size_t Faces = 0;
+			};
+
+			std::vector<ChunkBase> bases(chunkCount + 1);
+
+			for (size_t i = 0; i < chunkCount; ++i)
+			{
+				bases[i + 1].Vertices = bases[i].Vertices + chunks[i].Vertices.size();
+				bases[i + 1].UVs = bases[i].UVs + chunks[i].UVs.size();
+				bases[i + 1].Normals = bases[i].Normals + chunks[i].Normals.size();
+				bases[i + 1].Faces = bases[i].Faces + chunks[i].Faces.size();
+			}
+
+			Vertices.resize(bases[chunkCount].Vertices);
+			UVs.resize(bases[chunkCount].UVs);
+			Normals.resize(bases[chunkCount].Normals);
+			Faces.resize(bases[chunkCount].Faces);
+
+			pool.ParallelFor(chunkCount, [this, &chunks, &bases](size_t i)
+			{
+				ObjChunk& chunk = chunks[i];
+				const ChunkBase& base = bases[i];
+
+				std::copy(chunk.Vertices.begin(), chunk.Vertices.end(), Vertices.begin() + base.Vertices);
+				std::copy(chunk.UVs.begin(), chunk.UVs.end(), UVs.begin() + base.UVs);
+				std::copy(chunk.Normals.begin(), chunk.Normals.end(), Normals.begin() + base.Normals);
+				std::copy(chunk.Faces.begin(), chunk.Faces.end(), Faces.begin() + base.Faces);
+
+				for (size_t j = 0; j < chunk.Fixups.size(); ++j)
+				{
+					const ObjIndexFixup& fixup = chunk.Fixups[j];
+
+					Vertex& vertex = Faces[base.Faces + fixup.Face].Vertices[fixup.Vertex];
+
+					if (fixup.Component == 0)
+						vertex.Position += (int)base.Vertices;
+					else if (fixup.Component == 1)
+						vertex.UV += (int)base.UVs;
+					else
+						vertex.Normal += (int)base.Normals;
+				}
+			});
+
+			FinishFaces();
+		}
+
+		void ObjParser::Parse(std::istream& file, const std::string& filePath)
+		{
+			std::stringstream buffer;
+
+			buffer << file.rdbuf();
+
+			std::string data = buffer.str();
+
+			Parse(data.data(), data.size(), filePath);
 		}
 
 		void ObjParser::Parse(const std::string& filePath)
 		{
+			MappedFile mappedFile;
+
+			if (mappedFile.Open(filePath))
+			{
+				Parse(mappedFile.GetData(), mappedFile.GetSize(), filePath);
+
+				return;
+			}
+
 			std::ifstream file(filePath, std::ios_base::in);
 
 			if (!file.is_open() || !file.good())
@@ -183,8 +505,6 @@ namespace Engine
 
 				ReadVertex(tokenString, Polygon.Vertices[TokenNumber - 1]);
 
-				Polygon.Data[TokenNumber - 1] = tokenString;
-
 				if (TokenNumber == 3)
 					Faces.push_back(Polygon);
 
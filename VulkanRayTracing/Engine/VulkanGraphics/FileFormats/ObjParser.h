@@ -21,8 +21,6 @@ namespace Engine
 		struct Face
 		{
 			Vertex Vertices[3];
-
-			std::string Data[3];
 		};
 
 		struct ParseModeEnum
@@ -57,6 +55,10 @@ namespace Engine
 
 			void Parse(std::istream& stream, const std::string& filePath = "");
 			void Parse(const std::string& filePath = std::string(""));
+			void Parse(const char* data, size_t size, const std::string& filePath = "");
+
+			// the original character at a time scanner, kept around to benchmark against
+			void ParseCharacters(std::istream& stream, const std::string& filePath = "");
 
 		private:
 			ParseMode Mode;
@@ -66,6 +68,7 @@ namespace Engine
 			Face Polygon;
 
 			std::string Output(const std::string& filePath, int lineNumber, const std::string& error);
+			void FinishFaces();
 			void EvaluateToken();
 			ParseMode SelectMode(const std::string& token);
 			void ReadVertex(const std::string& token, Vertex& vertex);
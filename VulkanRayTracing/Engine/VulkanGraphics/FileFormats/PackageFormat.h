@@ -0,0 +1,99 @@
+#pragma once
+
+import <cstdint>;
+
+// on disk layout of .mpk packages. everything is addressed by its offset from the start of the file so the whole thing can be mapped
+// anywhere, and vertex buffers are aligned so meshes can use them straight out of the mapping
+namespace PackageFormat
+{
+	const std::uint32_t Magic = 0x4B504D2E; // ".MPK"
+	const std::uint32_t Version = 1;
+	const std::uint32_t ByteOrderMark = 0x01020304;
+	const std::uint64_t BufferAlignment = 16;
+	const std::uint64_t NoIndex = ~0ull;
+
+	struct StringRef
+	{
+		std::uint64_t Offset = 0;
+		std::uint64_t Length = 0;
+	};
+
+	struct Header
+	{
+		std::uint32_t Magic = PackageFormat::Magic;
+		std::uint32_t Version = PackageFormat::Version;
+		std::uint32_t ByteOrder = ByteOrderMark;
+		std::uint32_t Reserved = 0;
+		std::uint64_t FileSize = 0;
+		std::uint64_t AttributeCount = 0;
+		std::uint64_t AttributeOffset = 0;
+		std::uint64_t FormatCount = 0;
+		std::uint64_t FormatOffset = 0;
+		std::uint64_t MeshCount = 0;
+		std::uint64_t MeshOffset = 0;
+		std::uint64_t NodeCount = 0;
+		std::uint64_t NodeOffset = 0;
+		std::uint64_t MaterialCount = 0;
+		std::uint64_t MaterialOffset = 0;
+	};
+
+	struct Attribute
+	{
+		StringRef Name;
+		std::uint32_t Type = 0;
+		std::uint32_t ElementCount = 0;
+		std::uint64_t Binding = 0;
+	};
+
+	struct Format
+	{
+		std::uint64_t FirstAttribute = 0;
+		std::uint64_t AttributeCount = 0;
+	};
+
+	struct Mesh
+	{
+		std::uint64_t Format = NoIndex;
+		std::uint64_t Vertices = 0;
+		std::uint64_t BindingCount = 0;
+		std::uint64_t BindingOffset = 0; // table of BindingCount buffer offsets
+		std::uint64_t IndexCount = 0;
+		std::uint64_t IndexOffset = 0;
+	};
+
+	struct Node
+	{
+		StringRef Name;
+		StringRef TransformName;
+		std::uint64_t AttachedTo = NoIndex;
+		std::uint64_t MaterialIndex = NoIndex;
+		std::uint64_t Mesh = NoIndex;
+		std::uint64_t Format = NoIndex;
+		std::uint32_t HasTransform = 0;
+		std::uint32_t InheritsTransformation = 1;
+		double Transformation[4][4] = {};
+	};
+
+	struct Material
+	{
+		StringRef Name;
+		StringRef Diffuse;
+		StringRef Normal;
+		StringRef Specular;
+		StringRef OverrideColor;
+		float DiffuseColor[3] = {};
+		float SpecularColor[3] = {};
+		float AmbientColor[3] = {};
+		float EmissiveColor[3] = {};
+		float Shininess = 0;
+		float Alpha = 0;
+	};
+
+	// the records get copied to and from disk as is, so their layout can't depend on the compiler
+	static_assert(sizeof(Header) == 104);
+	static_assert(sizeof(Attribute) == 32);
+	static_assert(sizeof(Format) == 16);
+	static_assert(sizeof(Mesh) == 48);
+	static_assert(sizeof(Node) == 200);
+	static_assert(sizeof(Material) == 136);
+}
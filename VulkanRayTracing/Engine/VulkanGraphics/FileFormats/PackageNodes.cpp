@@ -0,0 +1,113 @@
+#include "PackageNodes.h"
+
+import <iostream>;
+
+#include <Engine/Objects/Transform.h>
+
+namespace Engine
+{
+	namespace Graphics
+	{
+		void ModelPackage::BuildHierarchy()
+		{
+			const size_t NoParent = (size_t)-1;
+
+			size_t nodeCount = Nodes.size();
+
+			// broken links come from the source file, so they're reported and the node is detached into a root instead of failing the whole load
+			for (size_t i = 0; i < nodeCount; ++i)
+			{
+				if (Nodes[i].AttachedTo != NoParent && Nodes[i].AttachedTo >= nodeCount)
+				{
+					std::cout << "warning: package node attached to a node that doesn't exist, treating it as a root: " << Nodes[i].Name << std::endl;
+
+					Nodes[i].AttachedTo = NoParent;
+				}
+			}
+
+			TopologicalOrder.clear();
+			TopologicalOrder.reserve(nodeCount);
+
+			// nodes go out in index order unless an ancestor hasn't been placed yet, in which case the missing part of the chain goes first
+			std::vector<unsigned char> state(nodeCount, 0);
+			std::vector<size_t> chain;
+
+			const unsigned char Pending = 1;
+			const unsigned char Placed = 2;
+
+			for (size_t i = 0; i < nodeCount; ++i)
+			{
+				for (size_t current = i; current != NoParent && state[current] != Placed; current = Nodes[current].AttachedTo)
+				{
+					// the last node in the chain closes the cycle, so detaching it is enough to break it
+					if (state[current] == Pending)
+					{
+						std::cout << "warning: package node hierarchy has a cycle, treating a node in it as a root: " << Nodes[chain.back()].Name << std::endl;
+
+						Nodes[chain.back()].AttachedTo = NoParent;
+
+						break;
+					}
+
+					state[current] = Pending;
+					chain.push_back(current);
+				}
+
+				for (; chain.size() > 0; chain.pop_back())
+				{
+					state[chain.back()] = Placed;
+					TopologicalOrder.push_back(chain.back());
+				}
+			}
+
+			ChildOffsets.assign(nodeCount + 1, 0);
+			RootNodes.clear();
+
+			// children are bucketed by a counting sort on the parent, which leaves each list in index order
+			for (size_t i = 0; i < nodeCount; ++i)
+			{
+				size_t parent = Nodes[i].AttachedTo;
+
+				if (parent == NoParent)
+					RootNodes.push_back(i);
+				else
+					++ChildOffsets[parent + 1];
+			}
+
+			for (size_t i = 0; i < nodeCount; ++i)
+				ChildOffsets[i + 1] += ChildOffsets[i];
+
+			ChildNodes.resize(ChildOffsets[nodeCount]);
+
+			std::vector<size_t> fill(ChildOffsets.begin(), ChildOffsets.end() - 1);
+
+			for (size_t i = 0; i < nodeCount; ++i)
+				if (Nodes[i].AttachedTo != NoParent)
+					ChildNodes[fill[Nodes[i].AttachedTo]++] = i;
+
+			Hierarchy.Clear();
+			Hierarchy.Reserve(nodeCount);
+			HierarchyEntries.assign(nodeCount, NoParent);
+
+			for (size_t i = 0; i < nodeCount; ++i)
+			{
+				const ModelPackageNode& node = Nodes[TopologicalOrder[i]];
+
+				size_t parent = node.AttachedTo != NoParent ? HierarchyEntries[node.AttachedTo] : NoParent;
+				Matrix4 transformation;
+
+				if (node.Transform != nullptr)
+				{
+					transformation = node.Transform->GetTransformation();
+
+					if (!node.Transform->InheritsTransformation())
+						parent = NoParent;
+				}
+
+				HierarchyEntries[TopologicalOrder[i]] = Hierarchy.Add(parent, transformation);
+			}
+
+			Hierarchy.Update();
+		}
+	}
+}
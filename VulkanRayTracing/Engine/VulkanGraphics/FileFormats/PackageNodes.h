@@ -5,6 +5,7 @@ import <memory>;
 import <vector>;
 
 #include <Engine/Math/Color3.h>
+#include <Engine/Objects/TransformHierarchy.h>
 
 namespace Engine
 {
@@ -45,6 +46,21 @@ namespace Engine
 		{
 			std::vector<ModelPackageNode> Nodes;
 			std::vector<ModelPackageMaterial> Materials;
+
+			// derived from AttachedTo by BuildHierarchy, which has to run again whenever nodes are added or reattached
+			std::vector<size_t> ChildOffsets;
+			std::vector<size_t> ChildNodes;
+			std::vector<size_t> RootNodes;
+			std::vector<size_t> TopologicalOrder;
+
+			// node transforms laid out in TopologicalOrder, world transforms are relative to the package root. HierarchyEntries maps each node to its entry
+			TransformHierarchy Hierarchy;
+			std::vector<size_t> HierarchyEntries;
+
+			void BuildHierarchy();
+			bool HasHierarchy() const { return ChildOffsets.size() == Nodes.size() + 1; }
+			size_t GetChildCount(size_t node) const { return ChildOffsets[node + 1] - ChildOffsets[node]; }
+			const size_t* GetChildren(size_t node) const { return ChildNodes.data() + ChildOffsets[node]; }
 		};
 	}
 }
\ No newline at end of file
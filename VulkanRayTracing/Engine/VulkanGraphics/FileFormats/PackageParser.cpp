@@ -0,0 +1,259 @@
+#include "PackageParser.h"
+
+import <vector>;
+import <string>;
+import <cstring>;
+
+#include <Engine/Objects/Transform.h>
+#include <Engine/VulkanGraphics/Scene/MeshData.h>
+#include "PackageNodes.h"
+#include "PackageFormat.h"
+
+using namespace PackageFormat;
+
+void PackageParser::Parse(std::istream& stream)
+{
+	std::shared_ptr<std::vector<char>> buffer = std::make_shared<std::vector<char>>();
+
+	stream.seekg(0, std::ios::end);
+
+	std::streamoff size = stream.tellg();
+
+	stream.seekg(0, std::ios::beg);
+
+	if (size > 0)
+	{
+		buffer->resize((size_t)size);
+		stream.read(buffer->data(), size);
+		buffer->resize((size_t)stream.gcount());
+	}
+
+	DataOwner = buffer;
+
+	Parse(buffer->data(), buffer->size());
+}
+
+void PackageParser::Parse(const char* data, size_t size)
+{
+	using Engine::Graphics::MeshFormat;
+	using Engine::Graphics::MeshData;
+	using Engine::Graphics::VertexAttributeFormat;
+
+	if (Package == nullptr)
+		throw "no package to parse into";
+
+	auto checkRange = [size](std::uint64_t offset, std::uint64_t count, std::uint64_t elementSize)
+	{
+		if (offset > size || (elementSize > 0 && count > (size - offset) / elementSize))
+			throw "package table out of range";
+	};
+
+	// records are copied out instead of pointed at, so a buffer that didn't come from a mapping doesn't have to be aligned
+	auto readTable = [data, &checkRange]<typename T>(std::vector<T>& records, std::uint64_t offset, std::uint64_t count)
+	{
+		checkRange(offset, count, sizeof(T));
+
+		records.resize((size_t)count);
+
+		if (count > 0)
+			std::memcpy(records.data(), data + offset, (size_t)count * sizeof(T));
+	};
+
+	auto readString = [data, &checkRange](const StringRef& string)
+	{
+		checkRange(string.Offset, string.Length, 1);
+
+		return std::string(data + string.Offset, (size_t)string.Length);
+	};
+
+	if (size < sizeof(Header))
+		throw "package file too small";
+
+	Header header;
+
+	std::memcpy(&header, data, sizeof(Header));
+
+	if (header.Magic != Magic)
+		throw "not a package file";
+
+	if (header.Version != Version)
+		throw "unsupported package version";
+
+	// buffers are used exactly as they were written, so a package from a machine with the other byte order can't be loaded in place
+	if (header.ByteOrder != ByteOrderMark)
+		throw "package byte order doesn't match";
+
+	if (header.FileSize > size)
+		throw "unexpected end of package file";
+
+	std::vector<Attribute> attributeRecords;
+	std::vector<Format> formatRecords;
+	std::vector<Mesh> meshRecords;
+	std::vector<Node> nodeRecords;
+	std::vector<Material> materialRecords;
+
+	readTable(attributeRecords, header.AttributeOffset, header.AttributeCount);
+	readTable(formatRecords, header.FormatOffset, header.FormatCount);
+	readTable(meshRecords, header.MeshOffset, header.MeshCount);
+	readTable(nodeRecords, header.NodeOffset, header.NodeCount);
+	readTable(materialRecords, header.MaterialOffset, header.MaterialCount);
+
+	std::vector<std::shared_ptr<MeshFormat>> formats(formatRecords.size());
+
+	for (size_t i = 0; i < formatRecords.size(); ++i)
+	{
+		const Format& record = formatRecords[i];
+
+		if (record.FirstAttribute > attributeRecords.size() || record.AttributeCount > attributeRecords.size() - record.FirstAttribute)
+			throw "package format out of range";
+
+		std::vector<VertexAttributeFormat> attributes((size_t)record.AttributeCount);
+
+		for (size_t j = 0; j < attributes.size(); ++j)
+		{
+			const Attribute& attribute = attributeRecords[(size_t)record.FirstAttribute + j];
+
+			if (attribute.Type >= Engine::Graphics::AttributeDataTypeEnum::Count)
+				throw "unknown package attribute type";
+
+			attributes[j].Type = (Enum::AttributeDataType)attribute.Type;
+			attributes[j].ElementCount = attribute.ElementCount;
+			attributes[j].Name = readString(attribute.Name);
+			attributes[j].Binding = (size_t)attribute.Binding;
+		}
+
+		formats[i] = MeshFormat::GetFormat(attributes);
+	}
+
+	auto getFormat = [&formats](std::uint64_t index) -> std::shared_ptr<MeshFormat>
+	{
+		if (index == NoIndex)
+			return nullptr;
+
+		if (index >= formats.size())
+			throw "package format index out of range";
+
+		return formats[(size_t)index];
+	};
+
+	std::vector<std::shared_ptr<MeshData>> meshes(meshRecords.size());
+
+	for (size_t i = 0; i < meshRecords.size(); ++i)
+	{
+		const Mesh& record = meshRecords[i];
+
+		std::shared_ptr<MeshFormat> format = getFormat(record.Format);
+		std::shared_ptr<MeshData> mesh = Engine::Create<MeshData>();
+
+		meshes[i] = mesh;
+
+		if (format == nullptr)
+			continue;
+
+		if (record.BindingCount != format->GetBindingCount())
+			throw "package mesh doesn't match its format";
+
+		mesh->SetFormat(format);
+
+		std::vector<std::uint64_t> bindingOffsets;
+
+		readTable(bindingOffsets, record.BindingOffset, record.BindingCount);
+
+		std::vector<void*> buffers(bindingOffsets.size());
+
+		for (size_t binding = 0; binding < buffers.size(); ++binding)
+		{
+			checkRange(bindingOffsets[binding], record.Vertices, format->GetVertexSize(binding));
+
+			buffers[binding] = const_cast<char*>(data + bindingOffsets[binding]);
+		}
+
+		if (DataOwner != nullptr)
+			mesh->AdoptVertices((size_t)record.Vertices, buffers.data(), DataOwner);
+		else
+		{
+			mesh->PushVertices((size_t)record.Vertices);
+
+			for (size_t binding = 0; binding < buffers.size(); ++binding)
+				if (mesh->GetTotalSize(binding) > 0)
+					std::memcpy(mesh->GetData()[binding], buffers[binding], mesh->GetTotalSize(binding));
+		}
+
+		// indices live in a plain vector on the mesh, so those always get copied
+		std::vector<int> indices;
+
+		readTable(indices, record.IndexOffset, record.IndexCount);
+
+		mesh->PushIndices(indices);
+	}
+
+	size_t firstNode = Package->Nodes.size();
+	size_t firstMaterial = Package->Materials.size();
+
+	for (size_t i = 0; i < materialRecords.size(); ++i)
+	{
+		const Material& record = materialRecords[i];
+
+		Engine::Graphics::ModelPackageMaterial material;
+
+		material.Name = readString(record.Name);
+		material.Diffuse = readString(record.Diffuse);
+		material.Normal = readString(record.Normal);
+		material.Specular = readString(record.Specular);
+		material.OverrideColor = readString(record.OverrideColor);
+		material.DiffuseColor = Color3(record.DiffuseColor[0], record.DiffuseColor[1], record.DiffuseColor[2]);
+		material.SpecularColor = Color3(record.SpecularColor[0], record.SpecularColor[1], record.SpecularColor[2]);
+		material.AmbientColor = Color3(record.AmbientColor[0], record.AmbientColor[1], record.AmbientColor[2]);
+		material.EmissiveColor = Color3(record.EmissiveColor[0], record.EmissiveColor[1], record.EmissiveColor[2]);
+		material.Shininess = record.Shininess;
+		material.Alpha = record.Alpha;
+
+		Package->Materials.push_back(material);
+	}
+
+	for (size_t i = 0; i < nodeRecords.size(); ++i)
+	{
+		const Node& record = nodeRecords[i];
+
+		if (record.AttachedTo != NoIndex && record.AttachedTo >= nodeRecords.size())
+			throw "package node parent out of range";
+
+		if (record.MaterialIndex != NoIndex && record.MaterialIndex >= materialRecords.size())
+			throw "package material index out of range";
+
+		if (record.Mesh != NoIndex && record.Mesh >= meshes.size())
+			throw "package mesh index out of range";
+
+		Engine::Graphics::ModelPackageNode node;
+
+		node.Name = readString(record.Name);
+		node.AttachedTo = record.AttachedTo == NoIndex ? (size_t)-1 : firstNode + (size_t)record.AttachedTo;
+		node.MaterialIndex = record.MaterialIndex == NoIndex ? (size_t)-1 : firstMaterial + (size_t)record.MaterialIndex;
+		node.Format = getFormat(record.Format);
+		node.Mesh = record.Mesh == NoIndex ? nullptr : meshes[(size_t)record.Mesh];
+
+		if (record.HasTransform)
+		{
+			Matrix4 transformation;
+
+			for (int y = 0; y < 4; ++y)
+				for (int x = 0; x < 4; ++x)
+					transformation.Data[y][x] = (Float)record.Transformation[y][x];
+
+			node.Transform = Engine::Create<Engine::Transform>();
+			node.Transform->Name = readString(record.TransformName);
+			node.Transform->SetTransformation(transformation);
+			node.Transform->SetInheritsTransformation(record.InheritsTransformation != 0);
+		}
+
+		Package->Nodes.push_back(node);
+	}
+
+	for (size_t i = firstNode; i < Package->Nodes.size(); ++i)
+	{
+		Engine::Graphics::ModelPackageNode& node = Package->Nodes[i];
+
+		if (node.AttachedTo != (size_t)-1 && node.Transform != nullptr && Package->Nodes[node.AttachedTo].Transform != nullptr)
+			node.Transform->SetParent(Package->Nodes[node.AttachedTo].Transform);
+	}
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+import <istream>;
+import <memory>;
+
+namespace Engine
+{
+	namespace Graphics
+	{
+		struct ModelPackage;
+	}
+}
+
+class PackageParser
+{
+public:
+	Engine::Graphics::ModelPackage* Package = nullptr;
+	std::shared_ptr<const void> DataOwner; // set when the parsed data outlives Parse, lets meshes use vertex buffers in place
+
+	void Parse(std::istream& stream);
+	void Parse(const char* data, size_t size);
+};
@@ -0,0 +1,231 @@
+#include "PackageWriter.h"
+
+import <vector>;
+import <map>;
+import <string>;
+import <cstring>;
+
+#include <Engine/Objects/Transform.h>
+#include <Engine/VulkanGraphics/Scene/MeshData.h>
+#include "PackageNodes.h"
+#include "PackageFormat.h"
+
+using namespace PackageFormat;
+
+void PackageWriter::Write(std::ostream& stream)
+{
+	using Engine::Graphics::MeshFormat;
+	using Engine::Graphics::MeshData;
+
+	if (Package == nullptr)
+		throw "no package to write";
+
+	std::vector<std::shared_ptr<MeshFormat>> formats;
+	std::vector<std::shared_ptr<MeshData>> meshes;
+	std::map<const MeshFormat*, std::uint64_t> formatIndices;
+	std::map<const MeshData*, std::uint64_t> meshIndices;
+
+	auto addFormat = [&formats, &formatIndices](const std::shared_ptr<MeshFormat>& format) -> std::uint64_t
+	{
+		if (format == nullptr)
+			return NoIndex;
+
+		auto entry = formatIndices.find(format.get());
+
+		if (entry != formatIndices.end())
+			return entry->second;
+
+		formatIndices[format.get()] = formats.size();
+		formats.push_back(format);
+
+		return formats.size() - 1;
+	};
+
+	// nodes can share meshes and formats, so each one is only stored once
+	for (size_t i = 0; i < Package->Nodes.size(); ++i)
+	{
+		const std::shared_ptr<MeshData>& mesh = Package->Nodes[i].Mesh;
+
+		addFormat(Package->Nodes[i].Format);
+
+		if (mesh == nullptr || meshIndices.find(mesh.get()) != meshIndices.end())
+			continue;
+
+		addFormat(mesh->GetFormat());
+
+		meshIndices[mesh.get()] = meshes.size();
+		meshes.push_back(mesh);
+	}
+
+	size_t attributeCount = 0;
+
+	for (size_t i = 0; i < formats.size(); ++i)
+		attributeCount += formats[i]->GetAttributes().size();
+
+	Header header;
+
+	std::vector<char> blob;
+
+	auto reserve = [&blob](size_t size, size_t alignment = 8) -> std::uint64_t
+	{
+		size_t offset = (blob.size() + alignment - 1) / alignment * alignment;
+
+		blob.resize(offset + size);
+
+		return offset;
+	};
+
+	auto pushString = [&blob](const std::string& text) -> StringRef
+	{
+		StringRef string{ blob.size(), text.size() };
+
+		blob.insert(blob.end(), text.begin(), text.end());
+
+		return string;
+	};
+
+	auto pushData = [&blob, &reserve](const void* data, size_t size) -> std::uint64_t
+	{
+		std::uint64_t offset = reserve(size, BufferAlignment);
+
+		if (size > 0)
+			std::memcpy(blob.data() + offset, data, size);
+
+		return offset;
+	};
+
+	// fixed size tables go up front so everything variable sized can just be appended behind them
+	reserve(sizeof(Header));
+
+	header.AttributeCount = attributeCount;
+	header.AttributeOffset = reserve(attributeCount * sizeof(Attribute));
+	header.FormatCount = formats.size();
+	header.FormatOffset = reserve(formats.size() * sizeof(Format));
+	header.MeshCount = meshes.size();
+	header.MeshOffset = reserve(meshes.size() * sizeof(Mesh));
+	header.NodeCount = Package->Nodes.size();
+	header.NodeOffset = reserve(Package->Nodes.size() * sizeof(Node));
+	header.MaterialCount = Package->Materials.size();
+	header.MaterialOffset = reserve(Package->Materials.size() * sizeof(Material));
+
+	std::vector<Attribute> attributeRecords;
+	std::vector<Format> formatRecords(formats.size());
+	std::vector<Mesh> meshRecords(meshes.size());
+	std::vector<Node> nodeRecords(Package->Nodes.size());
+	std::vector<Material> materialRecords(Package->Materials.size());
+
+	attributeRecords.reserve(attributeCount);
+
+	for (size_t i = 0; i < formats.size(); ++i)
+	{
+		const std::vector<Engine::Graphics::VertexAttributeFormat>& attributes = formats[i]->GetAttributes();
+
+		formatRecords[i].FirstAttribute = attributeRecords.size();
+		formatRecords[i].AttributeCount = attributes.size();
+
+		for (size_t j = 0; j < attributes.size(); ++j)
+		{
+			Attribute record;
+
+			record.Name = pushString(attributes[j].Name);
+			record.Type = (std::uint32_t)attributes[j].Type;
+			record.ElementCount = (std::uint32_t)attributes[j].ElementCount;
+			record.Binding = attributes[j].Binding;
+
+			attributeRecords.push_back(record);
+		}
+	}
+
+	for (size_t i = 0; i < Package->Nodes.size(); ++i)
+	{
+		const Engine::Graphics::ModelPackageNode& node = Package->Nodes[i];
+		Node& record = nodeRecords[i];
+
+		record.Name = pushString(node.Name);
+		record.AttachedTo = node.AttachedTo == (size_t)-1 ? NoIndex : node.AttachedTo;
+		record.MaterialIndex = node.MaterialIndex == (size_t)-1 ? NoIndex : node.MaterialIndex;
+		record.Mesh = node.Mesh == nullptr ? NoIndex : meshIndices[node.Mesh.get()];
+		record.Format = node.Format == nullptr ? NoIndex : formatIndices[node.Format.get()];
+
+		if (node.Transform != nullptr)
+		{
+			const Matrix4& transformation = node.Transform->GetTransformation();
+
+			record.TransformName = pushString(node.Transform->Name);
+			record.HasTransform = 1;
+			record.InheritsTransformation = node.Transform->InheritsTransformation() ? 1 : 0;
+
+			for (int y = 0; y < 4; ++y)
+				for (int x = 0; x < 4; ++x)
+					record.Transformation[y][x] = (double)transformation.Data[y][x];
+		}
+	}
+
+	for (size_t i = 0; i < Package->Materials.size(); ++i)
+	{
+		const Engine::Graphics::ModelPackageMaterial& material = Package->Materials[i];
+		Material& record = materialRecords[i];
+
+		auto copyColor = [](float* output, const Color3& color)
+		{
+			output[0] = color.R;
+			output[1] = color.G;
+			output[2] = color.B;
+		};
+
+		record.Name = pushString(material.Name);
+		record.Diffuse = pushString(material.Diffuse);
+		record.Normal = pushString(material.Normal);
+		record.Specular = pushString(material.Specular);
+		record.OverrideColor = pushString(material.OverrideColor);
+
+		copyColor(record.DiffuseColor, material.DiffuseColor);
+		copyColor(record.SpecularColor, material.SpecularColor);
+		copyColor(record.AmbientColor, material.AmbientColor);
+		copyColor(record.EmissiveColor, material.EmissiveColor);
+
+		record.Shininess = material.Shininess;
+		record.Alpha = material.Alpha;
+	}
+
+	for (size_t i = 0; i < meshes.size(); ++i)
+	{
+		const MeshData& mesh = *meshes[i];
+		Mesh& record = meshRecords[i];
+
+		size_t bindings = mesh.GetFormat() == nullptr ? 0 : mesh.GetFormat()->GetBindingCount();
+
+		record.Format = addFormat(mesh.GetFormat());
+		record.Vertices = mesh.GetVertices();
+		record.BindingCount = bindings;
+		record.BindingOffset = reserve(bindings * sizeof(std::uint64_t));
+
+		for (size_t binding = 0; binding < bindings; ++binding)
+		{
+			std::uint64_t offset = pushData(mesh.GetData()[binding], mesh.GetTotalSize(binding));
+
+			std::memcpy(blob.data() + record.BindingOffset + binding * sizeof(std::uint64_t), &offset, sizeof(offset));
+		}
+
+		record.IndexCount = mesh.GetTriangleVertices();
+		record.IndexOffset = pushData(mesh.GetIndexData(), record.IndexCount * sizeof(int));
+	}
+
+	header.FileSize = blob.size();
+
+	auto writeTable = [&blob](std::uint64_t offset, const auto& records)
+	{
+		if (records.size() > 0)
+			std::memcpy(blob.data() + offset, records.data(), records.size() * sizeof(records[0]));
+	};
+
+	std::memcpy(blob.data(), &header, sizeof(Header));
+
+	writeTable(header.AttributeOffset, attributeRecords);
+	writeTable(header.FormatOffset, formatRecords);
+	writeTable(header.MeshOffset, meshRecords);
+	writeTable(header.NodeOffset, nodeRecords);
+	writeTable(header.MaterialOffset, materialRecords);
+
+	stream.write(blob.data(), (std::streamsize)blob.size());
+}
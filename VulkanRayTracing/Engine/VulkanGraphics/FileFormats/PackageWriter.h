@@ -0,0 +1,19 @@
+#pragma once
+
+import <ostream>;
+
+namespace Engine
+{
+	namespace Graphics
+	{
+		struct ModelPackage;
+	}
+}
+
+class PackageWriter
+{
+public:
+	Engine::Graphics::ModelPackage* Package = nullptr;
+
+	void Write(std::ostream& stream);
+};
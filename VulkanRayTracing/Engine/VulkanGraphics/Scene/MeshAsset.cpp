@@ -1,12 +1,16 @@
 #include "MeshAsset.h"
 
+import <algorithm>;
+
 #include <Engine/VulkanGraphics/FileFormats/ObjParser.h>
 #include <Engine/VulkanGraphics/FileFormats/NifParser.h>
 #include "MeshData.h"
+#include "VertexWelder.h"
 #include <Engine/VulkanGraphics/Core/Mesh.h>
 #include <Engine/VulkanGraphics/Core/GraphicsWindow.h>
 #include <Engine/Math/Vector3S.h>
 #include <Engine/Math/Vector2S.h>
+#include <Engine/Assets/MappedFile.h>
 
 namespace Engine
 {
@@ -70,13 +74,6 @@ namespace Engine
 
 		}
 
-		struct VertexData
-		{
-			Vector3SF Position;
-			Vector3SF Normal;
-			Vector2SF TextureCoords;
-		};
-
 		void MeshAsset::Loading(std::istream& file)
 		{
 			const FilePath& extension = GetExtension();
@@ -85,56 +82,42 @@ namespace Engine
 			{
 				ObjParser parser;
 
-				parser.Parse(file);
+				MappedFile mappedFile;
+
+				if (mappedFile.Open(GetLoadedPath()))
+					parser.Parse(mappedFile.GetData(), mappedFile.GetSize(), GetLoadedPath().string());
+				else
+					parser.Parse(file, GetLoadedPath().string());
 
 				BaseFormat = GetObjFormat();
 
 				BaseData = Engine::Create<MeshData>();
 
-				VertexCount = parser.Faces.size() * 3;
-				IndexCount = VertexCount;
+				std::vector<ObjVertex> expanded;
 
-				BaseData->SetFormat(BaseFormat);
-				BaseData->PushVertices(VertexCount, false);
-				BaseData->PushIndices(IndexCount);
+				ExpandObjFaces(parser, expanded);
 
-				for (size_t i = 0; i < parser.Faces.size(); ++i)
-				{
-					BaseData->PushIndex(3 * i + 0, 3 * (int)i + 0);
-					BaseData->PushIndex(3 * i + 1, 3 * (int)i + 1);
-					BaseData->PushIndex(3 * i + 2, 3 * (int)i + 2);
+				VertexWelder welder;
 
-					VertexData vertices[3];
+				welder.Weld(expanded.data(), sizeof(ObjVertex), expanded.size());
 
-					Face& face = parser.Faces[i];
+				const std::vector<size_t>& uniqueVertices = welder.GetUniqueVertices();
 
-					for (size_t j = 0; j < 3; ++j)
-					{
-						Vertex& vertexInfo = face.Vertices[j];
+				std::vector<ObjVertex> welded(uniqueVertices.size());
 
-						vertices[j].Position = parser.Vertices[vertexInfo.Position];
+				for (size_t i = 0; i < uniqueVertices.size(); ++i)
+					welded[i] = expanded[uniqueVertices[i]];
 
-						if (vertexInfo.Normal != -1)
-							vertices[j].Normal = parser.Normals[vertexInfo.Normal];
+				VertexCount = welded.size();
+				IndexCount = expanded.size();
 
-						if (vertexInfo.UV != -1)
-							vertices[j].TextureCoords = parser.UVs[vertexInfo.UV];
-					}
-
-					Vector3SF faceNormal = (vertices[2].Position - vertices[0].Position).Cross((vertices[1].Position - vertices[0].Position)).Normalize();
-
-					for (size_t j = 0; j < 3; ++j)
-					{
-						Vertex& vertexInfo = face.Vertices[j];
-
-						if (vertexInfo.Normal == -1)
-							vertices[j].Normal = faceNormal;
-					}
+				BaseData->SetFormat(BaseFormat);
+				BaseData->PushVertices(VertexCount, false);
+				BaseData->PushIndices(welder.GetRemap());
 
-					void* vertexData = vertices;
+				void* vertexData = welded.data();
 
-					BaseFormat->Copy(&vertexData, BaseData->GetData(), BaseFormat, 3, i * 3);
-				}
+				BaseFormat->Copy(&vertexData, BaseData->GetData(), BaseFormat, VertexCount);
 
 				int cachedIndex = BaseFormat->GetCachedIndex();
 
@@ -0,0 +1,318 @@
+#include "MeshConversionPlan.h"
+
+import <cstring>;
+import <algorithm>;
+import <type_traits>;
+
+#include "MeshData.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define MESH_CONVERSION_SSE
+
+#include <immintrin.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+
+#define MESH_CONVERSION_AVX2_TARGET
+#else
+#define MESH_CONVERSION_AVX2_TARGET __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace Engine
+{
+	namespace Graphics
+	{
+		template <typename SourceType, typename DestinationType>
+		void ConvertSpan(const char* source, char* destination, size_t sourceStride, size_t destinationStride, size_t vertices, size_t elements)
+		{
+			if constexpr (std::is_same_v<SourceType, DestinationType>)
+			{
+				size_t size = elements * sizeof(SourceType);
+
+				if (sourceStride == size && destinationStride == size)
+				{
+					std::memcpy(destination, source, size * vertices);
+
+					return;
+				}
+
+				for (size_t i = 0; i < vertices; ++i)
+					std::memcpy(destination + i * destinationStride, source + i * sourceStride, size);
+			}
+			else
+			{
+				for (size_t i = 0; i < vertices; ++i)
+				{
+					const SourceType* input = reinterpret_cast<const SourceType*>(source + i * sourceStride);
+					DestinationType* output = reinterpret_cast<DestinationType*>(destination + i * destinationStride);
+
+					for (size_t j = 0; j < elements; ++j)
+						output[j] = (DestinationType)input[j];
+				}
+			}
+		}
+
+#ifdef MESH_CONVERSION_SSE
+		bool HasAvx2()
+		{
+			static const bool supported = []()
+			{
+#if defined(_MSC_VER)
+				int info[4] = {};
+
+				__cpuid(info, 0);
+
+				if (info[0] < 7)
+					return false;
+
+				__cpuid(info, 1);
+
+				bool hasAvx = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0;
+
+				// the os has to be saving the ymm registers too or the instructions fault
+				if (!hasAvx || (_xgetbv(0) & 0x6) != 0x6)
+					return false;
+
+				__cpuidex(info, 7, 0);
+
+				return (info[1] & (1 << 5)) != 0;
+#else
+				return __builtin_cpu_supports("avx2") != 0;
+#endif
+			}();
+
+			return supported;
+		}
+
+		MESH_CONVERSION_AVX2_TARGET size_t ConvertFloat64ToFloat32Avx2(const double* input, float* output, size_t count)
+		{
+			size_t i = 0;
+
+			for (; i + 4 <= count; i += 4)
+				_mm_storeu_ps(output + i, _mm256_cvtpd_ps(_mm256_loadu_pd(input + i)));
+
+			return i;
+		}
+
+		MESH_CONVERSION_AVX2_TARGET size_t ConvertInt32ToUInt16Avx2(const int* input, unsigned short* output, size_t count)
+		{
+			size_t i = 0;
+
+			for (; i + 16 <= count; i += 16)
+			{
+				__m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + i));
+				__m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + i + 8));
+
+				// sign extend the low 16 bits so the saturating pack becomes a plain truncation
+				low = _mm256_srai_epi32(_mm256_slli_epi32(low, 16), 16);
+				high = _mm256_srai_epi32(_mm256_slli_epi32(high, 16), 16);
+
+				__m256i packed = _mm256_permute4x64_epi64(_mm256_packs_epi32(low, high), 0xD8);
+
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(output + i), packed);
+			}
+
+			return i;
+		}
+#endif
+
+		void ConvertFloat64ToFloat32Run(const double* input, float* output, size_t count)
+		{
+			size_t i = 0;
+
+#ifdef MESH_CONVERSION_SSE
+			if (HasAvx2())
+				i = ConvertFloat64ToFloat32Avx2(input, output, count);
+
+			for (; i + 2 <= count; i += 2)
+				_mm_store_sd(reinterpret_cast<double*>(output + i), _mm_castps_pd(_mm_cvtpd_ps(_mm_loadu_pd(input + i))));
+#endif
+
+			for (; i < count; ++i)
+				output[i] = (float)input[i];
+		}
+
+		void ConvertFloat64ToFloat32(const char* source, char* destination, size_t sourceStride, size_t destinationStride, size_t vertices, size_t elements)
+		{
+			if (sourceStride == elements * sizeof(double) && destinationStride == elements * sizeof(float))
+			{
+				ConvertFloat64ToFloat32Run(reinterpret_cast<const double*>(source), reinterpret_cast<float*>(destination), vertices * elements);
+
+				return;
+			}
+
+			for (size_t i = 0; i < vertices; ++i)
+			{
+				const double* input = reinterpret_cast<const double*>(source + i * sourceStride);
+				float* output = reinterpret_cast<float*>(destination + i * destinationStride);
+
+				size_t j = 0;
+
+#ifdef MESH_CONVERSION_SSE
+				for (; j + 2 <= elements; j += 2)
+					_mm_store_sd(reinterpret_cast<double*>(output + j), _mm_castps_pd(_mm_cvtpd_ps(_mm_loadu_pd(input + j))));
+#endif
+
+				for (; j < elements; ++j)
+					output[j] = (float)input[j];
+			}
+		}
+
+		void ConvertInt32ToUInt16Run(const int* input, unsigned short* output, size_t count)
+		{
+			size_t i = 0;
+
+#ifdef MESH_CONVERSION_SSE
+			if (HasAvx2())
+				i = ConvertInt32ToUInt16Avx2(input, output, count);
+
+			for (; i + 8 <= count; i += 8)
+			{
+				__m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+				__m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i + 4));
+
+				low = _mm_srai_epi32(_mm_slli_epi32(low, 16), 16);
+				high = _mm_srai_epi32(_mm_slli_epi32(high, 16), 16);
+
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), _mm_packs_epi32(low, high));
+			}
+#endif
+
+			for (; i < count; ++i)
+				output[i] = (unsigned short)input[i];
+		}
+
+		void ConvertInt32ToUInt16(const char* source, char* destination, size_t sourceStride, size_t destinationStride, size_t vertices, size_t elements)
+		{
+			if (sourceStride == elements * sizeof(int) && destinationStride == elements * sizeof(unsigned short))
+			{
+				ConvertInt32ToUInt16Run(reinterpret_cast<const int*>(source), reinterpret_cast<unsigned short*>(destination), vertices * elements);
+
+				return;
+			}
+
+			ConvertSpan<int, unsigned short>(source, destination, sourceStride, destinationStride, vertices, elements);
+		}
+
+		template <typename... Types>
+		struct ConversionKernelTable
+		{
+			ConversionKernel Kernels[sizeof...(Types)][sizeof...(Types)] = {};
+
+			ConversionKernelTable()
+			{
+				size_t row = 0;
+
+				(FillRow<Types>(row++), ...);
+
+				Kernels[AttributeDataTypeEnum::Float64][AttributeDataTypeEnum::Float32] = &ConvertFloat64ToFloat32;
+				Kernels[AttributeDataTypeEnum::Int32][AttributeDataTypeEnum::UInt16] = &ConvertInt32ToUInt16;
+			}
+
+			template <typename SourceType>
+			void FillRow(size_t row)
+			{
+				size_t column = 0;
+
+				((Kernels[row][column++] = &ConvertSpan<SourceType, Types>), ...);
+			}
+		};
+
+		ConversionKernel GetConversionKernel(AttributeDataTypeEnum::AttributeDataType source, AttributeDataTypeEnum::AttributeDataType destination)
+		{
+			// same type order as AttributeDataType
+			static const auto kernels = ConversionKernelTable<float, double, bool, signed char, short, int, long long, unsigned char, unsigned short, unsigned int, unsigned long long>{};
+
+			if (source >= AttributeDataTypeEnum::Count || destination >= AttributeDataTypeEnum::Count)
+				return nullptr;
+
+			return kernels.Kernels[source][destination];
+		}
+
+		MeshConversionPlan::MeshConversionPlan(const MeshFormat& source, const MeshFormat& destination)
+		{
+			const std::vector<VertexAttributeFormat>& attributes = source.GetAttributes();
+
+			DestinationAttributeCount = destination.GetAttributes().size();
+
+			SourceStrides.resize(source.GetBindingCount());
+			DestinationStrides.resize(destination.GetBindingCount());
+
+			for (size_t i = 0; i < SourceStrides.size(); ++i)
+				SourceStrides[i] = source.GetVertexSize(i);
+
+			for (size_t i = 0; i < DestinationStrides.size(); ++i)
+				DestinationStrides[i] = destination.GetVertexSize(i);
+
+			for (size_t i = 0; i < attributes.size(); ++i)
+			{
+				const VertexAttributeFormat* target = destination.GetAttribute(attributes[i].Name);
+
+				if (target == nullptr)
+					continue;
+
+				ConversionSpan span;
+
+				span.SourceBinding = attributes[i].Binding;
+				span.DestinationBinding = target->Binding;
+				span.SourceOffset = attributes[i].Offset;
+				span.DestinationOffset = target->Offset;
+				span.Elements = std::min(attributes[i].ElementCount, target->ElementCount);
+				span.SourceType = attributes[i].Type;
+				span.DestinationType = target->Type;
+				span.Kernel = GetConversionKernel(span.SourceType, span.DestinationType);
+
+				if (span.Kernel == nullptr || span.Elements == 0)
+					continue;
+
+				// attributes that sit back to back in both formats with the same types get folded into one wider span
+				if (Spans.size() > 0)
+				{
+					ConversionSpan& last = Spans.back();
+
+					bool canMerge = last.Kernel == span.Kernel && last.SourceBinding == span.SourceBinding && last.DestinationBinding == span.DestinationBinding;
+
+					canMerge &= last.SourceOffset + last.Elements * GetDataSize(last.SourceType) == span.SourceOffset;
+					canMerge &= last.DestinationOffset + last.Elements * GetDataSize(last.DestinationType) == span.DestinationOffset;
+
+					if (canMerge)
+					{
+						last.Elements += span.Elements;
+
+						continue;
+					}
+				}
+
+				Spans.push_back(span);
+			}
+		}
+
+		void MeshConversionPlan::Execute(const void* const* source, void** destination, size_t vertices, size_t offsetCount) const
+		{
+			// work through the vertices in chunks so interleaved buffers stay in cache while every span gets its pass
+			const size_t ChunkSize = 1024;
+
+			size_t chunkSize = Spans.size() > 1 ? ChunkSize : vertices;
+
+			for (size_t start = 0; start < vertices; start += chunkSize)
+			{
+				size_t count = std::min(chunkSize, vertices - start);
+
+				for (size_t i = 0; i < Spans.size(); ++i)
+				{
+					const ConversionSpan& span = Spans[i];
+
+					size_t sourceStride = SourceStrides[span.SourceBinding];
+					size_t destinationStride = DestinationStrides[span.DestinationBinding];
+
+					const char* sourceChar = reinterpret_cast<const char*>(source[span.SourceBinding]) + start * sourceStride + span.SourceOffset;
+					char* destinationChar = reinterpret_cast<char*>(destination[span.DestinationBinding]) + (start + offsetCount) * destinationStride + span.DestinationOffset;
+
+					span.Kernel(sourceChar, destinationChar, sourceStride, destinationStride, count, span.Elements);
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+import <vector>;
+
+#include <Engine/VulkanGraphics/Core/BufferFormat.h>
+
+namespace Engine
+{
+	namespace Graphics
+	{
+		class MeshFormat;
+
+		typedef void(*ConversionKernel)(const char* source, char* destination, size_t sourceStride, size_t destinationStride, size_t vertices, size_t elements);
+
+		struct ConversionSpan
+		{
+			typedef AttributeDataTypeEnum::AttributeDataType AttributeDataType;
+
+			size_t SourceBinding = 0;
+			size_t DestinationBinding = 0;
+			size_t SourceOffset = 0;
+			size_t DestinationOffset = 0;
+			size_t Elements = 0;
+			AttributeDataType SourceType = AttributeDataType::Float32;
+			AttributeDataType DestinationType = AttributeDataType::Float32;
+			ConversionKernel Kernel = nullptr;
+		};
+
+		class MeshConversionPlan
+		{
+		public:
+			MeshConversionPlan(const MeshFormat& source, const MeshFormat& destination);
+
+			void Execute(const void* const* source, void** destination, size_t vertices, size_t offsetCount = 0) const;
+
+			const std::vector<ConversionSpan>& GetSpans() const { return Spans; }
+			size_t GetDestinationAttributeCount() const { return DestinationAttributeCount; }
+
+		private:
+			std::vector<ConversionSpan> Spans;
+			std::vector<size_t> SourceStrides;
+			std::vector<size_t> DestinationStrides;
+			size_t DestinationAttributeCount = 0;
+		};
+
+		ConversionKernel GetConversionKernel(AttributeDataTypeEnum::AttributeDataType source, AttributeDataTypeEnum::AttributeDataType destination);
+	}
+}
@@ -1,5 +1,7 @@
 #include "MeshData.h"
 
+import <cstring>;
+
 namespace Engine
 {
 	namespace Graphics
@@ -165,19 +167,43 @@ namespace Engine
 				VertexSizes.push_back(0);
 
 			VertexSizes[attribute.Binding] += attribute.GetSize();
-		}
 
-		struct stringpeak { float a[25] = {}; };
+			std::lock_guard<std::mutex> lock(PlanMutex);
+
+			ConversionPlans.clear();
+		}
 
 		void MeshFormat::Copy(const void* const * source, void** destination, const std::shared_ptr<MeshFormat>& destinationFormat, size_t vertices, size_t offsetCount) const
 		{
-			std::vector<int> mappings(Attributes.size());
+			GetConversionPlan(destinationFormat)->Execute(source, destination, vertices, offsetCount);
+		}
+
+		std::shared_ptr<const MeshConversionPlan> MeshFormat::GetConversionPlan(const std::shared_ptr<MeshFormat>& destinationFormat) const
+		{
+			std::lock_guard<std::mutex> lock(PlanMutex);
 
-			if (false) {
-				stringpeak peak;
-				peak.a[0] = 0;
+			auto entry = ConversionPlans.find(destinationFormat.get());
+
+			// plans are keyed on the raw pointer, so make sure it still points at the same format and that it hasn't grown since
+			if (entry != ConversionPlans.end())
+			{
+				const CachedConversionPlan& cached = entry->second;
+
+				if (cached.Destination.lock() == destinationFormat && cached.Plan->GetDestinationAttributeCount() == destinationFormat->Attributes.size())
+					return cached.Plan;
 			}
 
+			std::shared_ptr<const MeshConversionPlan> plan = std::make_shared<MeshConversionPlan>(*this, *destinationFormat);
+
+			ConversionPlans[destinationFormat.get()] = CachedConversionPlan{ destinationFormat, plan };
+
+			return plan;
+		}
+
+		void MeshFormat::CopyPerElement(const void* const * source, void** destination, const std::shared_ptr<MeshFormat>& destinationFormat, size_t vertices, size_t offsetCount) const
+		{
+			std::vector<int> mappings(Attributes.size());
+
 			for (size_t i = 0; i < mappings.size(); ++i)
 			{
 				auto index = destinationFormat->IndexMap.find(Attributes[i].Name);
@@ -234,6 +260,8 @@ namespace Engine
 
 		std::shared_ptr<MeshFormat> MeshFormat::GetCachedFormat(const std::string& hashString)
 		{
+			std::lock_guard<std::recursive_mutex> lock(CacheMutex);
+
 			auto entry = Cache.find(hashString);
 
 			if (entry != Cache.end())
@@ -244,6 +272,8 @@ namespace Engine
 
 		std::shared_ptr<MeshFormat> MeshFormat::GetCachedFormat(int index)
 		{
+			std::lock_guard<std::recursive_mutex> lock(CacheMutex);
+
 			if (index < 0 || index >= CacheVector.size())
 				return nullptr;
 
@@ -252,6 +282,8 @@ namespace Engine
 
 		void MeshFormat::CacheFormat(const std::string& hashString, const std::shared_ptr<MeshFormat>& format)
 		{
+			std::lock_guard<std::recursive_mutex> lock(CacheMutex);
+
 			Cache[hashString] = format;
 			CacheVector.push_back(format);
 
@@ -263,6 +295,8 @@ namespace Engine
 		{
 			std::string hash = format->GetHashString();
 
+			std::lock_guard<std::recursive_mutex> lock(CacheMutex);
+
 			if (GetCachedFormat(hash) == nullptr)
 				CacheFormat(hash, format);
 		}
@@ -291,6 +325,9 @@ namespace Engine
 
 			VertexAttributeFormat::GetHashString(hashString, attributes);
 
+			// lookup and insert have to happen under one lock or two threads can register the same format twice
+			std::lock_guard<std::recursive_mutex> lock(CacheMutex);
+
 			std::shared_ptr<MeshFormat> meshFormat = GetCachedFormat(hashString);
 
 			if (meshFormat == nullptr)
@@ -308,6 +345,8 @@ namespace Engine
 
 		void MeshData::SetFormat(const std::shared_ptr<MeshFormat>& format)
 		{
+			OwnData();
+
 			Format = format;
 
 			while (Data.size() < Format->GetBindingCount())
@@ -337,6 +376,8 @@ namespace Engine
 		{
 			if (Format == nullptr) return;
 
+			OwnData();
+
 			for (size_t binding = 0; binding < Data.size(); ++binding)
 			{
 				size_t newSize = Data[binding].size() + count * Format->GetVertexSize(binding);
@@ -359,6 +400,36 @@ namespace Engine
 			Vertices += count;
 		}
 
+		void MeshData::AdoptVertices(size_t count, void* const* buffers, const std::shared_ptr<const void>& owner)
+		{
+			if (Format == nullptr) return;
+
+			// the buffers are used in place, owner keeps whatever they point into alive for as long as the mesh does
+			for (size_t binding = 0; binding < Data.size(); ++binding)
+			{
+				Data[binding] = std::vector<unsigned char>();
+				DataPointers[binding] = buffers[binding];
+			}
+
+			Vertices = count;
+			ExternalData = owner;
+		}
+
+		void MeshData::OwnData()
+		{
+			if (ExternalData == nullptr) return;
+
+			for (size_t binding = 0; binding < Data.size(); ++binding)
+			{
+				const unsigned char* source = reinterpret_cast<const unsigned char*>(DataPointers[binding]);
+
+				Data[binding].assign(source, source + GetTotalSize(binding));
+				DataPointers[binding] = Data[binding].data();
+			}
+
+			ExternalData = nullptr;
+		}
+
 		void MeshData::PushIndices(size_t count)
 		{
 			Indices.resize(Indices.size() + count);
@@ -374,6 +445,36 @@ namespace Engine
 			Indices = indices;
 		}
 
+		void MeshData::PermuteVertices(const std::vector<int>& order)
+		{
+			if (Format == nullptr || order.size() != Vertices) return;
+
+			// order lists the old vertex that goes in each new slot, indices get pointed at the new slots
+			std::vector<int> newIndex(Vertices);
+
+			for (size_t i = 0; i < order.size(); ++i)
+				newIndex[order[i]] = (int)i;
+
+			for (size_t binding = 0; binding < Data.size(); ++binding)
+			{
+				size_t vertexSize = Format->GetVertexSize(binding);
+
+				const unsigned char* source = reinterpret_cast<const unsigned char*>(DataPointers[binding]);
+				std::vector<unsigned char> permuted(vertexSize * Vertices);
+
+				for (size_t i = 0; i < order.size(); ++i)
+					std::memcpy(permuted.data() + i * vertexSize, source + order[i] * vertexSize, vertexSize);
+
+				Data[binding] = std::move(permuted);
+				DataPointers[binding] = Data[binding].data();
+			}
+
+			for (size_t i = 0; i < Indices.size(); ++i)
+				Indices[i] = newIndex[Indices[i]];
+
+			ExternalData = nullptr;
+		}
+
 		void MeshData::ResetData()
 		{
 			for (size_t binding = 0; binding < Data.size(); ++binding)
@@ -385,6 +486,7 @@ namespace Engine
 			Indices.clear();
 
 			Vertices = 0;
+			ExternalData = nullptr;
 		}
 	}
 }
\ No newline at end of file
@@ -4,9 +4,11 @@ import <vector>;
 import <memory>;
 import <string>;
 import <map>;
+import <mutex>;
 
 #include <Engine/Objects/Object.h>
 #include <Engine/VulkanGraphics/Core/BufferFormat.h>
+#include "MeshConversionPlan.h"
 
 namespace Engine
 {
@@ -40,6 +42,8 @@ namespace Engine
 
 			void Push(const VertexAttributeFormat& attribute);
 			void Copy(const void* const* source, void** destination, const std::shared_ptr<MeshFormat>& destinationFormat, size_t vertices, size_t offsetCount = 0) const;
+			void CopyPerElement(const void* const* source, void** destination, const std::shared_ptr<MeshFormat>& destinationFormat, size_t vertices, size_t offsetCount = 0) const;
+			std::shared_ptr<const MeshConversionPlan> GetConversionPlan(const std::shared_ptr<MeshFormat>& destinationFormat) const;
 			void WriteAttribute(const void* const * source, void* destination, size_t attribute, size_t element) const;
 			void WriteAttribute(const void* const * source, void* destination, const std::string& attribute, size_t element) const;
 			std::string GetHashString() const;
@@ -58,12 +62,24 @@ namespace Engine
 			typedef std::map<std::string, std::shared_ptr<MeshFormat>> MeshFormatMap;
 			typedef std::vector<std::shared_ptr<MeshFormat>> MeshFormatVector;
 
+			struct CachedConversionPlan
+			{
+				std::weak_ptr<MeshFormat> Destination;
+				std::shared_ptr<const MeshConversionPlan> Plan;
+			};
+
+			typedef std::map<const MeshFormat*, CachedConversionPlan> ConversionPlanMap;
+
 			std::vector<VertexAttributeFormat> Attributes;
 			std::map<std::string, size_t> IndexMap;
 
+			mutable std::mutex PlanMutex;
+			mutable ConversionPlanMap ConversionPlans;
+
 			static inline MeshFormatMap Cache = MeshFormatMap();
 			static inline MeshFormatVector CacheVector = MeshFormatVector();
 			static inline int CachedFormats = 0;
+			static inline std::recursive_mutex CacheMutex;
 
 			size_t Bindings = 0;
 			std::vector<size_t> VertexSizes;
@@ -86,13 +102,16 @@ namespace Engine
 			const void* GetIndexData() const { return Indices.data(); }
 
 			void PushVertices(size_t count = 1, bool pushIndices = false);
+			void AdoptVertices(size_t count, void* const* buffers, const std::shared_ptr<const void>& owner);
 			void PushIndices(size_t count = 1);
 			void PushIndices(const std::vector<int>& indices);
 			void PushIndex(size_t location, int index);
+			void PermuteVertices(const std::vector<int>& order);
 			void ResetData();
 
 			//const std::vector<unsigned char>& GetVertexBuffer() const { return Data; }
 			const std::vector<int>& GetIndexBuffer() const { return Indices; }
+			bool IsAdopted() const { return ExternalData != nullptr; }
 
 		private:
 			std::shared_ptr<MeshFormat> Format;
@@ -101,6 +120,9 @@ namespace Engine
 			std::vector<std::vector<unsigned char>> Data;
 			std::vector<void*> DataPointers;
 			std::vector<int> Indices;
+			std::shared_ptr<const void> ExternalData;
+
+			void OwnData();
 		};
 	}
 }
\ No newline at end of file
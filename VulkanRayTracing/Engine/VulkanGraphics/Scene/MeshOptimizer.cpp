@@ -0,0 +1,426 @@
+#include "MeshOptimizer.h"
+
+import <algorithm>;
+import <cmath>;
+
+#include "MeshData.h"
+
+namespace Engine
+{
+	namespace Graphics
+	{
+		// simulates a fifo cache with timestamps, a vertex is cached while fewer than cacheSize misses have happened since it was loaded
+		struct VertexCacheSimulation
+		{
+			std::vector<size_t> LoadTimes;
+			size_t Time = 0;
+			size_t CacheSize = 0;
+
+			VertexCacheSimulation(size_t vertices, size_t cacheSize) : LoadTimes(vertices, 0), Time(cacheSize + 1), CacheSize(cacheSize) {}
+
+			bool IsCached(int vertex) const { return Time - LoadTimes[vertex] <= CacheSize; }
+			size_t GetAge(int vertex) const { return Time - LoadTimes[vertex]; }
+
+			size_t Touch(int vertex)
+			{
+				if (IsCached(vertex))
+					return 0;
+
+				LoadTimes[vertex] = Time++;
+
+				return 1;
+			}
+
+			void Flush()
+			{
+				Time += CacheSize + 1;
+			}
+		};
+
+		MeshOptimizationReport MeshOptimizer::Optimize(MeshData& mesh) const
+		{
+			MeshOptimizationReport report;
+
+			const std::vector<int>& indices = mesh.GetIndexBuffer();
+			size_t vertices = mesh.GetVertices();
+
+			report.Triangles = indices.size() / 3;
+			report.Vertices = vertices;
+
+			if (indices.size() == 0 || indices.size() % 3 != 0 || CacheSize == 0)
+				return report;
+
+			std::vector<char> referenced(vertices, 0);
+			size_t referencedCount = 0;
+
+			for (size_t i = 0; i < indices.size(); ++i)
+			{
+				if (indices[i] < 0 || (size_t)indices[i] >= vertices)
+					return report;
+
+				referencedCount += referenced[indices[i]] == 0;
+				referenced[indices[i]] = 1;
+			}
+
+			size_t missesBefore = CountCacheMisses(indices, vertices, CacheSize);
+
+			report.AcmrBefore = (double)missesBefore / (double)report.Triangles;
+			report.AtvrBefore = (double)missesBefore / (double)referencedCount;
+
+			std::vector<size_t> clusters;
+			std::vector<int> ordered = OrderTriangles(indices, vertices, clusters);
+			std::vector<float> positions;
+
+			if (OptimizeOverdraw && ReadPositions(mesh, positions))
+			{
+				SplitClusters(ordered, vertices, clusters);
+
+				ordered = SortClusters(ordered, positions, clusters);
+			}
+
+			report.Clusters = clusters.size();
+
+			mesh.PushIndices(ordered);
+
+			if (OptimizeVertexFetch)
+			{
+				// vertices get laid out in the order they're first used, anything unreferenced goes at the end
+				std::vector<int> order;
+				std::vector<char> placed(vertices, 0);
+
+				order.reserve(vertices);
+
+				for (size_t i = 0; i < ordered.size(); ++i)
+				{
+					if (placed[ordered[i]] == 0)
+					{
+						placed[ordered[i]] = 1;
+						order.push_back(ordered[i]);
+					}
+				}
+
+				for (size_t i = 0; i < vertices; ++i)
+					if (placed[i] == 0)
+						order.push_back((int)i);
+
+				bool changed = false;
+
+				for (size_t i = 0; i < order.size() && !changed; ++i)
+					changed = order[i] != (int)i;
+
+				if (changed)
+					mesh.PermuteVertices(order);
+			}
+
+			size_t missesAfter = CountCacheMisses(mesh.GetIndexBuffer(), vertices, CacheSize);
+
+			report.AcmrAfter = (double)missesAfter / (double)report.Triangles;
+			report.AtvrAfter = (double)missesAfter / (double)referencedCount;
+			report.Optimized = true;
+
+			return report;
+		}
+
+		size_t MeshOptimizer::CountCacheMisses(const std::vector<int>& indices, size_t vertices, size_t cacheSize)
+		{
+			VertexCacheSimulation cache(vertices, cacheSize);
+
+			size_t misses = 0;
+
+			for (size_t i = 0; i < indices.size(); ++i)
+				misses += cache.Touch(indices[i]);
+
+			return misses;
+		}
+
+		// tipsify, from sander, nehab and barczak's "fast triangle reordering for vertex locality and reduced overdraw"
+		std::vector<int> MeshOptimizer::OrderTriangles(const std::vector<int>& indices, size_t vertices, std::vector<size_t>& clusters) const
+		{
+			size_t triangles = indices.size() / 3;
+
+			std::vector<int> live(vertices, 0);
+			std::vector<size_t> offsets(vertices + 1, 0);
+			std::vector<int> adjacency(indices.size());
+
+			for (size_t i = 0; i < indices.size(); ++i)
+				++live[indices[i]];
+
+			for (size_t i = 0; i < vertices; ++i)
+				offsets[i + 1] = offsets[i] + live[i];
+
+			{
+				std::vector<size_t> fill(offsets.begin(), offsets.end() - 1);
+
+				for (size_t i = 0; i < indices.size(); ++i)
+					adjacency[fill[indices[i]]++] = (int)(i / 3);
+			}
+
+			VertexCacheSimulation cache(vertices, CacheSize);
+
+			std::vector<char> emitted(triangles, 0);
+			std::vector<int> deadEnd;
+			std::vector<int> candidates;
+			std::vector<int> output;
+
+			deadEnd.reserve(indices.size());
+			output.reserve(indices.size());
+
+			clusters.clear();
+			clusters.push_back(0);
+
+			size_t cursor = 0;
+
+			auto nextLiveVertex = [&live, &cursor, vertices]() -> int
+			{
+				for (; cursor < vertices; ++cursor)
+					if (live[cursor] > 0)
+						return (int)cursor;
+
+				return -1;
+			};
+
+			int fanning = nextLiveVertex();
+
+			while (fanning >= 0)
+			{
+				candidates.clear();
+
+				for (size_t i = offsets[fanning]; i < offsets[fanning + 1]; ++i)
+				{
+					int triangle = adjacency[i];
+
+					if (emitted[triangle])
+						continue;
+
+					for (size_t j = 0; j < 3; ++j)
+					{
+						int vertex = indices[3 * triangle + j];
+
+						output.push_back(vertex);
+						deadEnd.push_back(vertex);
+						candidates.push_back(vertex);
+
+						--live[vertex];
+
+						cache.Touch(vertex);
+					}
+
+					emitted[triangle] = 1;
+				}
+
+				// fan next from whichever candidate will still be cached after its remaining triangles have gone through, oldest first
+				// starts below any real priority so a candidate that won't stay cached can still be picked over a dead end jump
+				int next = -1;
+				long long bestPriority = -1;
+
+				for (size_t i = 0; i < candidates.size(); ++i)
+				{
+					int vertex = candidates[i];
+
+					if (live[vertex] == 0)
+						continue;
+
+					long long priority = 0;
+
+					if (cache.GetAge(vertex) + 2 * (size_t)live[vertex] <= CacheSize)
+						priority = (long long)cache.GetAge(vertex);
+
+					if (priority > bestPriority)
+					{
+						bestPriority = priority;
+						next = vertex;
+					}
+				}
+
+				while (next == -1 && deadEnd.size() > 0)
+				{
+					int vertex = deadEnd.back();
+
+					deadEnd.pop_back();
+
+					if (live[vertex] > 0)
+						next = vertex;
+				}
+
+				// nothing nearby is left, so the next triangles won't share anything with these ones
+				if (next == -1)
+				{
+					next = nextLiveVertex();
+
+					if (next != -1)
+						clusters.push_back(output.size() / 3);
+				}
+
+				fanning = next;
+			}
+
+			return output;
+		}
+
+		// splits the hard clusters wherever the cache has warmed up enough that cutting there costs less than OverdrawThreshold
+		void MeshOptimizer::SplitClusters(const std::vector<int>& indices, size_t vertices, std::vector<size_t>& clusters) const
+		{
+			size_t triangles = indices.size() / 3;
+
+			VertexCacheSimulation cache(vertices, CacheSize);
+
+			std::vector<size_t> split;
+
+			for (size_t i = 0; i < clusters.size(); ++i)
+			{
+				size_t start = clusters[i];
+				size_t end = i + 1 < clusters.size() ? clusters[i + 1] : triangles;
+
+				size_t clusterMisses = 0;
+
+				cache.Flush();
+
+				for (size_t j = 3 * start; j < 3 * end; ++j)
+					clusterMisses += cache.Touch(indices[j]);
+
+				double threshold = OverdrawThreshold * (double)clusterMisses / (double)(end - start);
+
+				size_t runningMisses = 0;
+				size_t runningTriangles = 0;
+
+				cache.Flush();
+
+				split.push_back(start);
+
+				for (size_t triangle = start; triangle < end; ++triangle)
+				{
+					for (size_t j = 0; j < 3; ++j)
+						runningMisses += cache.Touch(indices[3 * triangle + j]);
+
+					++runningTriangles;
+
+					if (triangle + 1 < end && (double)runningMisses / (double)runningTriangles <= threshold)
+					{
+						split.push_back(triangle + 1);
+
+						cache.Flush();
+
+						runningMisses = 0;
+						runningTriangles = 0;
+					}
+				}
+			}
+
+			clusters = split;
+		}
+
+		// clusters facing away from the middle of the mesh are likelier to occlude the rest, so they get drawn first
+		std::vector<int> MeshOptimizer::SortClusters(const std::vector<int>& indices, const std::vector<float>& positions, const std::vector<size_t>& clusters) const
+		{
+			struct ClusterInfo
+			{
+				double Centroid[3] = {};
+				double Normal[3] = {};
+				double Area = 0;
+				double SortKey = 0;
+			};
+
+			size_t triangles = indices.size() / 3;
+
+			std::vector<ClusterInfo> info(clusters.size());
+
+			double meshCentroid[3] = {};
+			double meshArea = 0;
+
+			for (size_t i = 0; i < clusters.size(); ++i)
+			{
+				size_t end = i + 1 < clusters.size() ? clusters[i + 1] : triangles;
+
+				ClusterInfo& cluster = info[i];
+
+				for (size_t triangle = clusters[i]; triangle < end; ++triangle)
+				{
+					const float* a = &positions[3 * indices[3 * triangle + 0]];
+					const float* b = &positions[3 * indices[3 * triangle + 1]];
+					const float* c = &positions[3 * indices[3 * triangle + 2]];
+
+					double ab[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+					double ac[3] = { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+					double normal[3] = { ab[1] * ac[2] - ab[2] * ac[1], ab[2] * ac[0] - ab[0] * ac[2], ab[0] * ac[1] - ab[1] * ac[0] };
+
+					double area = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+
+					for (size_t j = 0; j < 3; ++j)
+					{
+						double centroid = ((double)a[j] + b[j] + c[j]) / 3;
+
+						cluster.Centroid[j] += centroid * area;
+						cluster.Normal[j] += normal[j];
+						meshCentroid[j] += centroid * area;
+					}
+
+					cluster.Area += area;
+					meshArea += area;
+				}
+			}
+
+			if (meshArea > 0)
+				for (size_t j = 0; j < 3; ++j)
+					meshCentroid[j] /= meshArea;
+
+			for (size_t i = 0; i < info.size(); ++i)
+			{
+				ClusterInfo& cluster = info[i];
+
+				double normalLength = std::sqrt(cluster.Normal[0] * cluster.Normal[0] + cluster.Normal[1] * cluster.Normal[1] + cluster.Normal[2] * cluster.Normal[2]);
+
+				if (cluster.Area <= 0 || normalLength <= 0)
+					continue;
+
+				for (size_t j = 0; j < 3; ++j)
+					cluster.SortKey += (cluster.Centroid[j] / cluster.Area - meshCentroid[j]) * cluster.Normal[j] / normalLength;
+			}
+
+			std::vector<size_t> order(clusters.size());
+
+			for (size_t i = 0; i < order.size(); ++i)
+				order[i] = i;
+
+			std::stable_sort(order.begin(), order.end(), [&info](size_t left, size_t right) { return info[left].SortKey > info[right].SortKey; });
+
+			std::vector<int> output;
+
+			output.reserve(indices.size());
+
+			for (size_t i = 0; i < order.size(); ++i)
+			{
+				size_t end = order[i] + 1 < clusters.size() ? clusters[order[i] + 1] : triangles;
+
+				output.insert(output.end(), indices.begin() + 3 * clusters[order[i]], indices.begin() + 3 * end);
+			}
+
+			return output;
+		}
+
+		bool MeshOptimizer::ReadPositions(const MeshData& mesh, std::vector<float>& positions) const
+		{
+			const std::shared_ptr<MeshFormat>& format = mesh.GetFormat();
+
+			if (format == nullptr)
+				return false;
+
+			const VertexAttributeFormat* position = format->GetAttribute("position");
+
+			if (position == nullptr)
+				return false;
+
+			ConversionKernel kernel = GetConversionKernel(position->Type, AttributeDataTypeEnum::Float32);
+
+			if (kernel == nullptr)
+				return false;
+
+			positions.assign(3 * mesh.GetVertices(), 0);
+
+			const char* source = reinterpret_cast<const char*>(mesh.GetData()[position->Binding]) + position->Offset;
+
+			kernel(source, reinterpret_cast<char*>(positions.data()), format->GetVertexSize(position->Binding), 3 * sizeof(float), mesh.GetVertices(), std::min(position->ElementCount, (size_t)3));
+
+			return true;
+		}
+	}
+}
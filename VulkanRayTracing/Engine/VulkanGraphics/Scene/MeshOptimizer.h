@@ -0,0 +1,43 @@
+#pragma once
+
+import <vector>;
+
+namespace Engine
+{
+	namespace Graphics
+	{
+		class MeshData;
+
+		struct MeshOptimizationReport
+		{
+			size_t Triangles = 0;
+			size_t Vertices = 0;
+			size_t Clusters = 0;
+			double AcmrBefore = 0; // cache misses per triangle
+			double AcmrAfter = 0;
+			double AtvrBefore = 0; // cache misses per referenced vertex, 1 is as good as it gets
+			double AtvrAfter = 0;
+			bool Optimized = false;
+		};
+
+		// reorders triangles for the post transform vertex cache, then orders clusters of them to cut overdraw and lays vertices out in fetch order
+		class MeshOptimizer
+		{
+		public:
+			size_t CacheSize = 16;
+			double OverdrawThreshold = 1.05; // how much worse than the vertex cache order a cluster split for overdraw is allowed to make things
+			bool OptimizeOverdraw = true;
+			bool OptimizeVertexFetch = true;
+
+			MeshOptimizationReport Optimize(MeshData& mesh) const;
+
+			static size_t CountCacheMisses(const std::vector<int>& indices, size_t vertices, size_t cacheSize);
+
+		private:
+			std::vector<int> OrderTriangles(const std::vector<int>& indices, size_t vertices, std::vector<size_t>& clusters) const;
+			void SplitClusters(const std::vector<int>& indices, size_t vertices, std::vector<size_t>& clusters) const;
+			std::vector<int> SortClusters(const std::vector<int>& indices, const std::vector<float>& positions, const std::vector<size_t>& clusters) const;
+			bool ReadPositions(const MeshData& mesh, std::vector<float>& positions) const;
+		};
+	}
+}
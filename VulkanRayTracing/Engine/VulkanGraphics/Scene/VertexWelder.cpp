@@ -0,0 +1,157 @@
+#include "VertexWelder.h"
+
+import <cstring>;
+import <algorithm>;
+
+#include <Engine/Assets/ContentHash.h>
+#include <Engine/ThreadPool.h>
+#include <Engine/VulkanGraphics/FileFormats/ObjParser.h>
+
+namespace Engine
+{
+	namespace Graphics
+	{
+		void VertexWelder::Weld(const void* vertices, size_t stride, size_t count)
+		{
+			const size_t ChunkSize = 0x4000;
+			const size_t ShardCount = 64;
+
+			const char* bytes = reinterpret_cast<const char*>(vertices);
+
+			Remap.resize(count);
+			UniqueVertices.clear();
+
+			if (count == 0)
+				return;
+
+			if (count > 0x7FFFFFFF)
+				throw "too many vertices to weld into 32 bit indices";
+
+			size_t chunks = (count + ChunkSize - 1) / ChunkSize;
+
+			std::vector<unsigned long long> hashes(count);
+
+			ThreadPool::GetShared().ParallelFor(chunks, [&hashes, bytes, stride, count, ChunkSize](size_t chunk)
+			{
+				size_t end = std::min(count, (chunk + 1) * ChunkSize);
+
+				for (size_t i = chunk * ChunkSize; i < end; ++i)
+					hashes[i] = ContentHash::Hash(bytes + i * stride, stride);
+			});
+
+			// equal vertices always land in the same shard, so every shard can be deduplicated on its own
+			std::vector<std::vector<int>> shards(ShardCount);
+
+			for (size_t i = 0; i < count; ++i)
+				shards[hashes[i] >> 58].push_back((int)i);
+
+			// first holds the earliest input vertex that's identical to each vertex
+			std::vector<int> first(count);
+
+			ThreadPool::GetShared().ParallelFor(ShardCount, [&shards, &hashes, &first, bytes, stride](size_t shard)
+			{
+				const std::vector<int>& members = shards[shard];
+
+				size_t tableSize = 16;
+
+				while (tableSize < members.size() * 2)
+					tableSize *= 2;
+
+				std::vector<int> table(tableSize, -1);
+
+				for (size_t i = 0; i < members.size(); ++i)
+				{
+					int vertex = members[i];
+					size_t slot = (size_t)hashes[vertex] & (tableSize - 1);
+
+					while (true)
+					{
+						int entry = table[slot];
+
+						if (entry == -1)
+						{
+							table[slot] = vertex;
+							first[vertex] = vertex;
+
+							break;
+						}
+
+						if (hashes[entry] == hashes[vertex] && std::memcmp(bytes + entry * stride, bytes + vertex * stride, stride) == 0)
+						{
+							first[vertex] = entry;
+
+							break;
+						}
+
+						slot = (slot + 1) & (tableSize - 1);
+					}
+				}
+			});
+
+			// numbering in input order keeps the output deterministic no matter how the shards were scheduled
+			for (size_t i = 0; i < count; ++i)
+			{
+				if (first[i] == (int)i)
+				{
+					Remap[i] = (int)UniqueVertices.size();
+					UniqueVertices.push_back(i);
+				}
+				else
+					Remap[i] = Remap[first[i]];
+			}
+		}
+
+		double VertexWelder::GetReductionRatio() const
+		{
+			if (UniqueVertices.size() == 0)
+				return 1;
+
+			return (double)Remap.size() / (double)UniqueVertices.size();
+		}
+
+		void ExpandObjFaces(ObjParser& parser, std::vector<ObjVertex>& expanded)
+		{
+			const size_t ChunkSize = 0x1000;
+
+			size_t faces = parser.Faces.size();
+			size_t chunks = (faces + ChunkSize - 1) / ChunkSize;
+
+			expanded.assign(faces * 3, ObjVertex());
+
+			ThreadPool::GetShared().ParallelFor(chunks, [&parser, &expanded, faces, ChunkSize](size_t chunk)
+			{
+				size_t end = std::min(faces, (chunk + 1) * ChunkSize);
+
+				for (size_t i = chunk * ChunkSize; i < end; ++i)
+				{
+					ObjVertex* vertices = expanded.data() + 3 * i;
+
+					Face& face = parser.Faces[i];
+
+					for (size_t j = 0; j < 3; ++j)
+					{
+						Vertex& vertexInfo = face.Vertices[j];
+
+						vertices[j].Position = parser.Vertices[vertexInfo.Position];
+
+						if (vertexInfo.Normal != -1)
+							vertices[j].Normal = parser.Normals[vertexInfo.Normal];
+
+						if (vertexInfo.UV != -1)
+							vertices[j].TextureCoords = parser.UVs[vertexInfo.UV];
+					}
+
+					Vector3SF faceNormal = (vertices[2].Position - vertices[0].Position).Cross((vertices[1].Position - vertices[0].Position)).Normalize();
+
+					for (size_t j = 0; j < 3; ++j)
+					{
+						Vertex& vertexInfo = face.Vertices[j];
+
+						if (vertexInfo.Normal == -1)
+							vertices[j].Normal = faceNormal;
+					}
+				}
+			});
+		}
+	}
+}
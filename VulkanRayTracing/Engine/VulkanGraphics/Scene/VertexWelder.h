@@ -0,0 +1,46 @@
+#pragma once
+
+import <vector>;
+
+#include <Engine/Math/Vector3S.h>
+#include <Engine/Math/Vector2S.h>
+
+namespace Engine
+{
+	namespace Graphics
+	{
+		class ObjParser;
+
+		// one vertex per face corner of an obj, laid out to match the obj mesh format
+		struct ObjVertex
+		{
+			Vector3SF Position;
+			Vector3SF Normal;
+			Vector2SF TextureCoords;
+		};
+
+		// every face is expanded on its own, corners without a normal get the face's flat normal. the result is what gets welded
+		void ExpandObjFaces(ObjParser& parser, std::vector<ObjVertex>& expanded);
+
+		// collapses bitwise identical vertices so a flat vertex list can become an indexed mesh
+		class VertexWelder
+		{
+		public:
+			void Weld(const void* vertices, size_t stride, size_t count);
+
+			size_t GetInputCount() const { return Remap.size(); }
+			size_t GetUniqueCount() const { return UniqueVertices.size(); }
+			double GetReductionRatio() const;
+
+			// maps each input vertex to its welded index, which makes it the index buffer for a flat triangle list
+			const std::vector<int>& GetRemap() const { return Remap; }
+
+			// the first input vertex that each welded vertex came from
+			const std::vector<size_t>& GetUniqueVertices() const { return UniqueVertices; }
+
+		private:
+			std::vector<int> Remap;
+			std::vector<size_t> UniqueVertices;
+		};
+	}
+}
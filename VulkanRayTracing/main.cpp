@@ -9,6 +9,10 @@ import <sstream>;
 import <memory>;
 import <fstream>;
 import <set>;
+import <chrono>;
+import <thread>;
+import <exception>;
+import <atomic>;
 
 #include <Windows.h>
 
@@ -57,6 +61,11 @@ import <set>;
 #include <Engine/VulkanGraphics/Scene/SceneDrawOperation.h>
 #include <Engine/VulkanGraphics/Scene/Scene.h>
 #include <Engine/Assets/ModelPackageAsset.h>
+#include <Engine/ThreadPool.h>
+#include <Engine/Assets/AssetCache.h>
+#include <Engine/Assets/ContentHash.h>
+
+#include "Benchmarks.h"
 
 using namespace Engine;
 
@@ -159,6 +168,11 @@ void init(int argc, char** argv)
 	std::string inputDirectory = "import/";
 	std::string outputDirectory = "export/";
 	bool recursiveSearch = false;
+	size_t jobs = 1;
+	FbxExportSettings fbxSettings;
+	std::unique_ptr<AssetCache> cache;
+	std::string exportExtension;
+	bool optimizeMeshes = false;
 
 	std::vector<std::string> extensionBlacklist;
 	std::vector<std::string> extensionWhitelist;
@@ -180,6 +194,69 @@ void init(int argc, char** argv)
 		if (arg == "--export-dir" && i + 1 < argc)
 			outputDirectory = argv[i + 1];
 
+		if (arg == "--jobs" && i + 1 < argc)
+		{
+			int requested = std::atoi(argv[i + 1]);
+
+			jobs = requested > 0 ? (size_t)requested : std::thread::hardware_concurrency();
+		}
+
+		if (arg == "--fbx-compression" && i + 1 < argc)
+		{
+			std::string level = argv[i + 1];
+
+			if (level == "none")
+				fbxSettings.Compression = FbxCompression::None;
+			else if (level == "fast")
+				fbxSettings.Compression = FbxCompression::Fast;
+			else if (level == "best")
+				fbxSettings.Compression = FbxCompression::Best;
+			else
+				fbxSettings.Compression = FbxCompression::Default;
+		}
+
+		if (arg == "--optimize-meshes")
+			optimizeMeshes = true;
+
+		if (arg == "--export-format" && i + 1 < argc)
+			exportExtension = std::string(".") + argv[i + 1];
+
+		if (arg == "--cache-dir" && i + 1 < argc)
+			cache = std::make_unique<AssetCache>(argv[i + 1]);
+
+		if (arg == "--fbx-compression-threshold" && i + 1 < argc)
+			fbxSettings.CompressionThreshold = (size_t)std::atoll(argv[i + 1]);
+
+		if (arg == "--benchmark-mesh-copy")
+			benchmarkMeshCopy();
+
+		if (arg == "--benchmark-binary-reader")
+			benchmarkBinaryReader();
+
+		if (arg == "--benchmark-nif-strings")
+			benchmarkNifStrings();
+
+		if (arg == "--benchmark-obj" && i + 1 < argc)
+			benchmarkObjParser(argv[i + 1]);
+
+		if (arg == "--benchmark-fbx" && i + 1 < argc)
+			benchmarkFbxNodes(argv[i + 1]);
+
+		if (arg == "--benchmark-nif" && i + 1 < argc)
+			benchmarkNifDocument(argv[i + 1]);
+
+		if (arg == "--benchmark-allocator")
+			benchmarkPageAllocator();
+
+		if (arg == "--benchmark-object-ids")
+			benchmarkObjectIDs();
+
+		if (arg == "--benchmark-hierarchy")
+			benchmarkTransformHierarchy();
+
+		if (arg == "--benchmark-transform-chain")
+			benchmarkTransformChain();
+
 		if (arg == "--ignore-extensions")
 			for (int j = 1; i + j < argc && argv[i + j][0] != '-'; ++j)
 				extensionBlacklist.push_back(argv[i + j]);
@@ -354,7 +431,9 @@ void init(int argc, char** argv)
 		}
 	}
 	
-	for (size_t i = 0; i < hairs.size(); ++i)
+	std::atomic<size_t> cacheHits = 0;
+
+	auto convertAsset = [&](size_t i, std::ostream& log)
 	{
 		hairs[i].asset = Engine::Create<Engine::ModelPackageAsset>();
 		hairs[i].transform = Engine::Create<Transform>();
@@ -365,26 +444,74 @@ void init(int argc, char** argv)
 		if (canUseOutput)
 			hairs[i].asset->SetExportPath(outputDirectory);
 
+		hairs[i].asset->FbxSettings = fbxSettings;
+		hairs[i].asset->OptimizeMeshes = optimizeMeshes;
+
+		std::filesystem::path fileName(assets[i]);
+
+		if (exportExtension.size() > 0)
+			fileName.replace_extension(exportExtension);
+		else if (fileName.extension().string() == ".fbx")
+			fileName.replace_extension(".nif");
+		else
+			fileName.replace_extension(".fbx");
+
+		std::filesystem::path outputPath = outputDirectory + fileName.string();
+
+		// the viewer needs the loaded package, so only batch conversions can skip straight to a cached output
+		bool useCache = cache != nullptr && doExport && !initVulkan;
+		unsigned long long cacheKey = 0;
+
+		if (useCache)
+		{
+			ContentHash hash;
+
+			useCache = cache->HashInput(inputDirectory + assets[i], hash);
+
+			if (useCache)
+			{
+				hairs[i].asset->HashExportSettings(hash, fileName.extension());
+
+				cacheKey = hash.Finish();
+
+				if (cache->Fetch(cacheKey, outputPath))
+				{
+					log << "exported '" << outputPath.string() << "' from cache" << std::endl;
+
+					++cacheHits;
+
+					hairs[i] = hairobj();
+
+					return;
+				}
+			}
+		}
+
 		hairs[i].asset->SetPath(assets[i], Enum::AssetType::GameAsset, std::ios::binary);
 		hairs[i].asset->Load();
 
-		std::cout << "imported '" << (inputDirectory + assets[i]) << "'" << std::endl;
+		log << "imported '" << (inputDirectory + assets[i]) << "'" << std::endl;
 
-		if (doExport)
+		const std::vector<Graphics::MeshOptimizationReport>& reports = hairs[i].asset->GetOptimizationReports();
+
+		for (size_t j = 0; j < reports.size(); ++j)
 		{
-			std::filesystem::path fileName(assets[i]);
+			if (!reports[j].Optimized)
+				continue;
 
-			if (fileName.extension().string() == ".fbx")
-				hairs[i].asset->Export(".nif");
-			else
-				hairs[i].asset->Export(".fbx");
+			log << "\toptimized mesh " << j << "; " << reports[j].Triangles << " triangles, " << reports[j].Clusters << " clusters" << std::endl;
+			log << "\t\tACMR: " << reports[j].AcmrBefore << " -> " << reports[j].AcmrAfter << std::endl;
+			log << "\t\tATVR: " << reports[j].AtvrBefore << " -> " << reports[j].AtvrAfter << std::endl;
+		}
 
-			if (fileName.extension().string() == ".fbx")
-				fileName.replace_extension(".nif");
-			else
-				fileName.replace_extension(".fbx");
+		if (doExport)
+		{
+			hairs[i].asset->Export(fileName.extension().string());
+
+			log << "exported '" << outputPath.string() << "'" << std::endl;
 
-			std::cout << "exported '" << (outputDirectory + fileName.string()) << "'" << std::endl;
+			if (useCache)
+				cache->Store(cacheKey, outputPath);
 		}
 
 
@@ -427,17 +554,17 @@ void init(int argc, char** argv)
 						const std::vector<Graphics::VertexAttributeFormat>& attributes = format->GetAttributes();
 						size_t bindings = format->GetBindingCount();
 
-						std::cout << "found new mesh format in loaded package; " << bindings << " vertex buffer bindings with " << attributes.size() << " attributes" << std::endl;
+						log << "found new mesh format in loaded package; " << bindings << " vertex buffer bindings with " << attributes.size() << " attributes" << std::endl;
 
 						for (size_t binding = 0; binding < bindings; ++binding)
 						{
-							std::cout << "\tbinding " << binding << "; " << format->GetVertexSize(binding) << " bytes" << std::endl;
+							log << "\tbinding " << binding << "; " << format->GetVertexSize(binding) << " bytes" << std::endl;
 
 							for (size_t i = 0; i < attributes.size(); ++i)
 							{
 								if (attributes[i].Binding == binding)
 								{
-									std::cout << "\t\t[" << attributes[i].Offset << "] " << Graphics::GetDataName(attributes[i].Type) << "[" << attributes[i].ElementCount << "] " << attributes[i].Name << std::endl;
+									log << "\t\t[" << attributes[i].Offset << "] " << Graphics::GetDataName(attributes[i].Type) << "[" << attributes[i].ElementCount << "] " << attributes[i].Name << std::endl;
 								}
 							}
 						}
@@ -451,17 +578,17 @@ void init(int argc, char** argv)
 				{
 					const Engine::Graphics::ModelPackageMaterial& material = package.Materials[j];
 
-					std::cout << "found new material in loaded package: '" << material.Name << std::endl;
-					std::cout << "\tdiffuse: " << material.Diffuse << std::endl;
-					std::cout << "\tnormal: " << material.Normal << std::endl;
-					std::cout << "\tspecular: " << material.Specular << std::endl;
-					std::cout << "\toverride: " << material.OverrideColor << std::endl;
-					std::cout << "\tdiffuse color:" << material.DiffuseColor << std::endl;
-					std::cout << "\tspecular color:" << material.SpecularColor << std::endl;
-					std::cout << "\tambient color:" << material.AmbientColor << std::endl;
-					std::cout << "\temissive color:" << material.EmissiveColor << std::endl;
-					std::cout << "\tshininess exponent:" << material.Shininess << std::endl;
-					std::cout << "\talpha:" << material.Alpha << std::endl;
+					log << "found new material in loaded package: '" << material.Name << std::endl;
+					log << "\tdiffuse: " << material.Diffuse << std::endl;
+					log << "\tnormal: " << material.Normal << std::endl;
+					log << "\tspecular: " << material.Specular << std::endl;
+					log << "\toverride: " << material.OverrideColor << std::endl;
+					log << "\tdiffuse color:" << material.DiffuseColor << std::endl;
+					log << "\tspecular color:" << material.SpecularColor << std::endl;
+					log << "\tambient color:" << material.AmbientColor << std::endl;
+					log << "\temissive color:" << material.EmissiveColor << std::endl;
+					log << "\tshininess exponent:" << material.Shininess << std::endl;
+					log << "\talpha:" << material.Alpha << std::endl;
 				}
 			}
 		}
@@ -497,6 +624,77 @@ void init(int argc, char** argv)
 
 		if (!initVulkan)
 			hairs[i] = hairobj();
+	};
+
+	size_t totalBytes = 0;
+
+	for (size_t i = 0; i < assets.size(); ++i)
+	{
+		std::error_code error;
+		std::uintmax_t size = std::filesystem::file_size(inputDirectory + assets[i], error);
+
+		if (!error)
+			totalBytes += (size_t)size;
+	}
+
+	auto startTime = std::chrono::steady_clock::now();
+
+	// the scene isn't safe to touch from more than one thread, so only batch conversions get spread out
+	bool runParallel = jobs > 1 && !initVulkan;
+
+	if (runParallel)
+	{
+		std::vector<std::stringstream> logs(hairs.size());
+		std::vector<std::exception_ptr> errors(hairs.size());
+
+		{
+			ThreadPool pool(jobs);
+
+			for (size_t i = 0; i < hairs.size(); ++i)
+			{
+				pool.Queue([&convertAsset, &logs, &errors, i]()
+				{
+					try
+					{
+						convertAsset(i, logs[i]);
+					}
+					catch (...)
+					{
+						errors[i] = std::current_exception();
+					}
+				});
+			}
+
+			pool.Wait();
+		}
+
+		for (size_t i = 0; i < hairs.size(); ++i)
+		{
+			std::cout << logs[i].str();
+
+			if (errors[i] != nullptr)
+				std::rethrow_exception(errors[i]);
+		}
+	}
+	else
+	{
+		for (size_t i = 0; i < hairs.size(); ++i)
+			convertAsset(i, std::cout);
+	}
+
+	if (hairs.size() > 0)
+	{
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+		double megabytes = (double)totalBytes / (1024 * 1024);
+
+		if (seconds <= 0)
+			seconds = 1e-9;
+
+		std::cout << "converted " << hairs.size() << " files (" << megabytes << " MB) in " << seconds << "s using " << (runParallel ? jobs : 1) << " jobs; ";
+		std::cout << ((double)hairs.size() / seconds) << " files/sec, " << (megabytes / seconds) << " MB/sec" << std::endl;
+
+		if (cache != nullptr)
+			std::cout << cacheHits << " of " << hairs.size() << " files served from cache '" << cache->GetDirectory().string() << "'" << std::endl;
 	}
 
 	//hairMeshAsset->SetPath("models/10200238_f_freeconcept020_a.nif", Enum::AssetType::GameAsset, std::ios::binary);